@@ -0,0 +1,406 @@
+// main.cpp : ByteBuffer encode/decode throughput benchmark.
+//
+// Usage: bytebuffer_bench [--out result.json] [--baseline base.json]
+//                         [--threshold 10] [--filter name] [--quick]
+//
+// Every case runs for a fixed time and reports ns per item and MB/s of
+// encoded data. --out writes the results as JSON, one result per line.
+// --baseline reads such a file and reports every case that got slower by
+// more than --threshold percent; the exit code is 1 if any did.
+// Also builds with g++: g++ -O2 -I../../common main.cpp -lboost_thread
+
+#include "stdafx.h"
+#include <stdlib.h>
+
+#ifndef _WIN32
+#include <chrono>
+#endif
+
+struct BenchRecord
+{
+	int					id;
+	double				value;
+	std::string			name;
+	std::vector<short>	tags;
+};
+DEC_BUF_OP4(BenchRecord, id, value, name, tags)
+
+static double bench_now()
+{
+#ifdef _WIN32
+	// steady_clock in VS2013 only has system clock resolution
+	static LARGE_INTEGER freq = { 0 };
+	LARGE_INTEGER t;
+	if (!freq.QuadPart)
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&t);
+	return (double)t.QuadPart / freq.QuadPart;
+#else
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// keeps the optimizer from dropping decoded values
+static volatile unsigned long long g_sink;
+
+struct BenchData
+{
+	size_t								items;
+	std::vector<int>					ints;
+	std::vector<std::string>			strings;
+	std::map<int, std::string>			map;
+	std::vector<BenchRecord>			records;
+	std::vector<unsigned char>			raw_src, raw_dst;
+
+	explicit BenchData(size_t n) : items(n)
+	{
+		ints.resize(n);
+		strings.resize(n);
+		records.resize(n);
+		for (size_t i = 0; i < n; i++){
+			ints[i] = (int)(i * 2654435761u);
+			strings[i].assign(8 + i % 40, (char)('a' + i % 26));
+			map[(int)i * 3] = strings[i];
+			records[i].id = (int)i;
+			records[i].value = i * 0.5;
+			records[i].name = strings[i];
+			records[i].tags.assign(i % 5, (short)i);
+		}
+		raw_src.assign(n * sizeof(int), 0x5a);
+		raw_dst.resize(raw_src.size());
+	}
+};
+
+// encode into b (cleared by the caller), decode from b (rpos reset by the caller)
+struct BenchCase
+{
+	const char	*name;
+	void		(*encode)(ByteBuffer &b, BenchData &d);
+	void		(*decode)(ByteBuffer &b, BenchData &d);
+};
+
+static void enc_memcpy(ByteBuffer &b, BenchData &d)
+{
+	memcpy(&d.raw_dst[0], &d.raw_src[0], d.raw_src.size());
+	b.wpos(0);
+	g_sink += d.raw_dst[d.items / 2];
+}
+
+static void dec_memcpy(ByteBuffer &b, BenchData &d)
+{
+	memcpy(&d.raw_src[0], &d.raw_dst[0], d.raw_dst.size());
+	g_sink += d.raw_src[d.items / 2];
+}
+
+static void enc_primitives(ByteBuffer &b, BenchData &d)
+{
+	for (size_t i = 0; i < d.items; i++)
+		b << (int)i << (double)i << (short)i << (long long)i;
+}
+
+static void dec_primitives(ByteBuffer &b, BenchData &d)
+{
+	int a; double f; short s; long long l;
+	unsigned long long sum = 0;
+	for (size_t i = 0; i < d.items; i++){
+		b >> a >> f >> s >> l;
+		sum += a + s + l;
+	}
+	g_sink += sum;
+}
+
+static void enc_strings(ByteBuffer &b, BenchData &d)
+{
+	for (size_t i = 0; i < d.items; i++)
+		b << d.strings[i];
+}
+
+static void dec_strings(ByteBuffer &b, BenchData &d)
+{
+	std::string s;
+	unsigned long long sum = 0;
+	for (size_t i = 0; i < d.items; i++){
+		b >> s;
+		sum += s.size();
+	}
+	g_sink += sum;
+}
+
+static void enc_cstrings(ByteBuffer &b, BenchData &d)
+{
+	b << ByteBuffer::vec_head_size<0>();
+	enc_strings(b, d);
+}
+
+static void dec_cstrings(ByteBuffer &b, BenchData &d)
+{
+	b >> ByteBuffer::vec_head_size<0>();
+	dec_strings(b, d);
+}
+
+static void enc_vector_int(ByteBuffer &b, BenchData &d)
+{
+	b << ByteBuffer::vec_head_size<4>() << d.ints;
+}
+
+static void dec_vector_int(ByteBuffer &b, BenchData &d)
+{
+	std::vector<int> v;
+	b >> ByteBuffer::vec_head_size<4>() >> v;
+	g_sink += v.size();
+}
+
+static void enc_vector_string(ByteBuffer &b, BenchData &d)
+{
+	b << ByteBuffer::vec_head_size<4>() << d.strings;
+}
+
+static void dec_vector_string(ByteBuffer &b, BenchData &d)
+{
+	std::vector<std::string> v;
+	b >> ByteBuffer::vec_head_size<4>() >> v;
+	g_sink += v.size();
+}
+
+static void enc_map(ByteBuffer &b, BenchData &d)
+{
+	b << d.map;
+}
+
+static void dec_map(ByteBuffer &b, BenchData &d)
+{
+	std::map<int, std::string> m;
+	b >> m;
+	g_sink += m.size();
+}
+
+static void enc_records(ByteBuffer &b, BenchData &d)
+{
+	for (size_t i = 0; i < d.items; i++)
+		b << d.records[i];
+}
+
+static void dec_records(ByteBuffer &b, BenchData &d)
+{
+	BenchRecord r;
+	unsigned long long sum = 0;
+	for (size_t i = 0; i < d.items; i++){
+		b >> r;
+		sum += r.id + r.tags.size();
+	}
+	g_sink += sum;
+}
+
+static const BenchCase g_cases[] = {
+	{ "memcpy",			enc_memcpy,			dec_memcpy },
+	{ "primitives",		enc_primitives,		dec_primitives },
+	{ "string",			enc_strings,		dec_strings },
+	{ "cstring",		enc_cstrings,		dec_cstrings },
+	{ "vector_int",		enc_vector_int,		dec_vector_int },
+	{ "vector_string",	enc_vector_string,	dec_vector_string },
+	{ "map_int_string",	enc_map,			dec_map },
+	{ "struct",			enc_records,		dec_records },
+};
+
+struct BenchSize
+{
+	const char	*name;
+	size_t		items;
+};
+
+static const BenchSize g_sizes[] = {
+	{ "small",	16 },
+	{ "medium",	4096 },
+	{ "huge",	1 << 20 },
+};
+
+struct BenchResult
+{
+	std::string	name, size, op;
+	double		items, bytes, ns_per_op, mb_per_s;
+};
+
+// calls f in batches of at least 1ms until min_time has passed,
+// returns the best seconds per call
+template<typename F>
+static double bench_time(F f, double min_time)
+{
+	size_t reps = 1;
+	for (;;){
+		double t0 = bench_now();
+		for (size_t i = 0; i < reps; i++)
+			f();
+		if (bench_now() - t0 >= 0.001)
+			break;
+		reps *= 2;
+	}
+
+	double best = 1e30, total = 0;
+	int batches = 0;
+	while (total < min_time || batches < 3){
+		double t0 = bench_now();
+		for (size_t i = 0; i < reps; i++)
+			f();
+		double t = bench_now() - t0;
+		if (t < best)
+			best = t;
+		total += t;
+		batches++;
+	}
+	return best / reps;
+}
+
+struct EncodeCall
+{
+	const BenchCase *c; BenchData *d; ByteBuffer *b;
+	void operator()() const { b->wpos(0); b->rpos(0); c->encode(*b, *d); }
+};
+
+struct DecodeCall
+{
+	const BenchCase *c; BenchData *d; ByteBuffer *b;
+	void operator()() const { b->rpos(0); c->decode(*b, *d); }
+};
+
+static void print_result(FILE *f, const BenchResult &r)
+{
+	fprintf(f, "{\"name\":\"%s\",\"size\":\"%s\",\"op\":\"%s\",\"items\":%.0f,\"bytes\":%.0f,\"ns_per_op\":%.3f,\"mb_per_s\":%.1f}",
+		r.name.c_str(), r.size.c_str(), r.op.c_str(), r.items, r.bytes, r.ns_per_op, r.mb_per_s);
+}
+
+static bool write_json(const char *path, const std::vector<BenchResult> &results)
+{
+	FILE *f = path ? fopen(path, "w") : stdout;
+	if (!f)
+		return false;
+#if defined(_MSC_VER)
+	fprintf(f, "{\"compiler\":\"msvc %d\",\"results\":[\n", _MSC_VER);
+#elif defined(__VERSION__)
+	fprintf(f, "{\"compiler\":\"gcc %s\",\"results\":[\n", __VERSION__);
+#else
+	fprintf(f, "{\"compiler\":\"unknown\",\"results\":[\n");
+#endif
+	for (size_t i = 0; i < results.size(); i++){
+		print_result(f, results[i]);
+		fprintf(f, i + 1 < results.size() ? ",\n" : "\n");
+	}
+	fprintf(f, "]}\n");
+	if (path)
+		fclose(f);
+	return true;
+}
+
+// reads a file written by write_json
+static bool read_json(const char *path, std::vector<BenchResult> &results)
+{
+	FILE *f = fopen(path, "r");
+	if (!f)
+		return false;
+	char line[512], name[64], size[16], op[16];
+	BenchResult r;
+	while (fgets(line, sizeof(line), f)){
+		if (sscanf(line, "{\"name\":\"%63[^\"]\",\"size\":\"%15[^\"]\",\"op\":\"%15[^\"]\",\"items\":%lf,\"bytes\":%lf,\"ns_per_op\":%lf,\"mb_per_s\":%lf",
+			name, size, op, &r.items, &r.bytes, &r.ns_per_op, &r.mb_per_s) == 7){
+			r.name = name;
+			r.size = size;
+			r.op = op;
+			results.push_back(r);
+		}
+	}
+	fclose(f);
+	return true;
+}
+
+// prints the cases that got slower than threshold percent, returns how many
+static int compare_baseline(const std::vector<BenchResult> &base, const std::vector<BenchResult> &cur, double threshold)
+{
+	int regressions = 0;
+	printf("\n%-16s %-7s %-7s %12s %12s %8s\n", "case", "size", "op", "base ns/op", "ns/op", "change");
+	for (size_t i = 0; i < cur.size(); i++){
+		for (size_t j = 0; j < base.size(); j++){
+			if (base[j].name != cur[i].name || base[j].size != cur[i].size || base[j].op != cur[i].op)
+				continue;
+			double change = base[j].ns_per_op > 0 ? (cur[i].ns_per_op / base[j].ns_per_op - 1) * 100 : 0;
+			bool slow = change > threshold;
+			printf("%-16s %-7s %-7s %12.3f %12.3f %+7.1f%%%s\n", cur[i].name.c_str(), cur[i].size.c_str(), cur[i].op.c_str(),
+				base[j].ns_per_op, cur[i].ns_per_op, change, slow ? "  REGRESSION" : "");
+			if (slow)
+				regressions++;
+			break;
+		}
+	}
+	return regressions;
+}
+
+int main(int argc, char* argv[])
+{
+	const char *out = 0, *baseline = 0, *filter = 0;
+	double threshold = 10, min_time = 0.3;
+	for (int i = 1; i < argc; i++){
+		if (!strcmp(argv[i], "--out") && i + 1 < argc)
+			out = argv[++i];
+		else if (!strcmp(argv[i], "--baseline") && i + 1 < argc)
+			baseline = argv[++i];
+		else if (!strcmp(argv[i], "--threshold") && i + 1 < argc)
+			threshold = atof(argv[++i]);
+		else if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+			filter = argv[++i];
+		else if (!strcmp(argv[i], "--quick"))
+			min_time = 0.05;
+		else{
+			fprintf(stderr, "usage: %s [--out file] [--baseline file] [--threshold pct] [--filter name] [--quick]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	std::vector<BenchResult> results;
+	printf("%-16s %-7s %-7s %10s %12s %10s\n", "case", "size", "op", "items", "ns/op", "MB/s");
+	for (size_t s = 0; s < sizeof(g_sizes) / sizeof(g_sizes[0]); s++){
+		BenchData data(g_sizes[s].items);
+		for (size_t c = 0; c < sizeof(g_cases) / sizeof(g_cases[0]); c++){
+			const BenchCase &bc = g_cases[c];
+			if (filter && !strstr(bc.name, filter))
+				continue;
+
+			ByteBuffer b;
+			EncodeCall enc = { &bc, &data, &b };
+			DecodeCall dec = { &bc, &data, &b };
+			double te = bench_time(enc, min_time);
+			size_t bytes = bc.encode == enc_memcpy ? data.raw_src.size() : b.size();
+			double td = bench_time(dec, min_time);
+
+			const char *ops[] = { "encode", "decode" };
+			double times[] = { te, td };
+			for (int k = 0; k < 2; k++){
+				BenchResult r;
+				r.name = bc.name;
+				r.size = g_sizes[s].name;
+				r.op = ops[k];
+				r.items = (double)data.items;
+				r.bytes = (double)bytes;
+				r.ns_per_op = times[k] * 1e9 / data.items;
+				r.mb_per_s = bytes / times[k] / (1024 * 1024);
+				results.push_back(r);
+				printf("%-16s %-7s %-7s %10.0f %12.3f %10.1f\n", r.name.c_str(), r.size.c_str(), r.op.c_str(),
+					r.items, r.ns_per_op, r.mb_per_s);
+			}
+		}
+	}
+
+	if (out && !write_json(out, results)){
+		fprintf(stderr, "can not write %s\n", out);
+		return 2;
+	}
+
+	if (baseline){
+		std::vector<BenchResult> base;
+		if (!read_json(baseline, base)){
+			fprintf(stderr, "can not read %s\n", baseline);
+			return 2;
+		}
+		int n = compare_baseline(base, results, threshold);
+		printf("%d regression(s) over %.1f%%\n", n, threshold);
+		return n ? 1 : 0;
+	}
+	return 0;
+}
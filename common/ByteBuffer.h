@@ -8,13 +8,37 @@
 #include <map>
 #include <string>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <iterator>
+#include <limits>
 #include <boost/smart_ptr.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/type_traits/is_pod.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/array.hpp>
+#include <boost/container/flat_map.hpp>
+#include <boost/container/flat_set.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <array>
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define BYTEBUFFER_HAS_STRING_VIEW 1
+#include <string_view>
+#endif
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#define BYTEBUFFER_HAS_SPAN 1
+#include <span>
+#endif
+#include "ByteBufferPool.h"
+#include "ByteOrder.h"
 using namespace std;
 
 
 struct ByteBufferException
 {
-    ByteBufferException(const char *act, unsigned int rp, unsigned int wp, unsigned int rs, unsigned int cs=0)
+    ByteBufferException(const char *act, size_t rp, size_t wp, size_t rs, size_t cs=0)
     {
         action = act;
         rpos = rp;
@@ -22,84 +46,121 @@ struct ByteBufferException
         readsize = rs;
         cursize = cs;
     }
-    unsigned int rpos, wpos, readsize, cursize;
+    size_t rpos, wpos, readsize, cursize;
     const char *action;
 };
 
 
 #define BUF_VEC_WIDTH  2
 
+//ڴС֮2
+#define BUF_MIN_CAPACITY  64
+
 #define BYTEBUFFER_OP(type)		ByteBuffer &operator<<(type value)\
 {\
-	append<type>(value);	\
+	append_value(value);	\
 	return *this;		\
 }	\
 ByteBuffer &operator>>(type &value) \
 {\
-	read<type>(value);	\
+	read_value(value);	\
 	return *this;\
 }
 
-//COWģʽܻ߳̿ϵ⡣
+//԰ڴֱӸƵ(bool)memcpy
+template<typename T>
+struct buf_blittable : boost::integral_constant<bool,
+	boost::is_arithmetic<typename boost::remove_cv<T>::type>::value &&
+	!boost::is_same<typename boost::remove_cv<T>::type, bool>::value>
+{
+};
+
+//varintģʽ°varint
+template<typename T>
+struct buf_varint_type : boost::integral_constant<bool,
+	boost::is_integral<T>::value && (sizeof(T) > 1)>
+{
+};
+
+//ֽvarintģʽ°LEB128д룬зzigzag
+#define BYTEBUFFER_INT_OP(type)		ByteBuffer &operator<<(type value)\
+{\
+	if (varint_)	\
+		append_varint(value);	\
+	else	\
+		append_value(value);	\
+	return *this;		\
+}	\
+ByteBuffer &operator>>(type &value) \
+{\
+	if (varint_)	\
+		read_varint(value);	\
+	else	\
+		read_value(value);	\
+	return *this;\
+}
+
+//COWģʽܻ߳̿ϵ⡣Ҫ̼߳乲ֻݣʹFrozenByteBuffer
 struct ByteBuffer
 {
     public:
 		//
-		ByteBuffer(const void *data,unsigned int size,bool bcopy = false){
-			rpos_=0;
-			array_with_bytes_=BUF_VEC_WIDTH;
+		ByteBuffer(const void *data,size_t size,bool bcopy = false){
+			init();
 			if (bcopy){
-				raw_data_ptr_=0;
-				data_size_ = 0;
-				storage_size_ = 0;
 				append(data,size);
 			}else{
-				data_ptr_.reset();
-				raw_data_ptr_=const_cast<unsigned char *>((unsigned char *)data);
-				data_size_ = 0;
+				raw_data_ptr_=const_cast<unsigned char *>((const unsigned char *)data);
 				storage_size_ = size;
 			}
 		}
 		
-		ByteBuffer(boost::shared_ptr<unsigned char> data,unsigned int size){
-			array_with_bytes_=BUF_VEC_WIDTH;
-			rpos_=0;
-			data_size_=size;
+		//data鷽ʽͷţ boost::shared_ptr<unsigned char>(p, boost::checked_array_deleter<unsigned char>())
+		//readonlyΪtrueʱdataд(ֻӳ)κд붼ȸƵµĴ洢
+		ByteBuffer(boost::shared_ptr<unsigned char> data,size_t size,bool readonly = false){
+			init();
+			wpos_=size;
 			data_ptr_ = data;
 			raw_data_ptr_=data.get();
-			storage_size_ = data_size_;
+			storage_size_ = size;
+			readonly_ = readonly && data;
 		}
 
 		ByteBuffer &operator=(const ByteBuffer& b)
 		{
+			if (this == &b)
+				return *this;
+
 			array_with_bytes_=b.array_with_bytes_;
+			varint_=b.varint_;
+			byte_order_=b.byte_order_;
 			rpos_ = 0;
 
 			if (b.data_ptr_!=NULL){				//COW
 				data_ptr_ = b.data_ptr_;
-				data_size_ = b.data_size_;
+				readonly_ = b.readonly_;
+				wpos_ = b.wpos_;
 				raw_data_ptr_=b.raw_data_ptr_;
-				storage_size_ = data_size_;
+				storage_size_ = b.storage_size_;
 
 			}else{
-				raw_data_ptr_=0;
-				data_size_ = 0;
-				storage_size_ = 0;
+				data_ptr_.reset();
+				readonly_ = false;
+				raw_data_ptr_=inline_ptr_;
+				wpos_ = 0;
+				storage_size_ = inline_size_;
 				append(b.contents(),b.size());
 			}
 			return *this;
 		}
 
 		ByteBuffer(const ByteBuffer& b){
+			init();
 			*this = b;
 		}
 		
 		ByteBuffer(){
-			rpos_=0;
-			wpos_=0;
-			storage_size_ = 0;
-			raw_data_ptr_ = 0;
-			array_with_bytes_=BUF_VEC_WIDTH;
+			init();
 		}
 		
         unsigned char operator[](size_t pos)
@@ -107,7 +168,7 @@ struct ByteBuffer
             return raw_data_ptr_[pos];
         }
 		
-        size_t rpos()
+        size_t rpos() const
         {
             return rpos_;
         };
@@ -118,7 +179,7 @@ struct ByteBuffer
             return rpos_;
         };
 
-        size_t wpos()
+        size_t wpos() const
         {
             return wpos_;
         }
@@ -143,16 +204,20 @@ struct ByteBuffer
 		};
 		
         unsigned char *contents() const { return (unsigned char *)dataptr(); };
+
+		//ĶѴ洢ⲿڴ洢ʱΪա
+		//һ԰ȫcontents()֮дȸһ(COW)
+		boost::shared_ptr<unsigned char> storage() const { return data_ptr_; }
 		
 		void peek(size_t pos,unsigned char *dest, size_t len)
 		{
-			if (pos + len <= size())
+			if (pos <= size() && len <= size() - pos)
 			{
 				memcpy(dest, (dataptr()+pos), len);
 			}
 			else
 			{
-				throw ByteBufferException("read-into", pos, wpos_, len,data_size_);
+				throw ByteBufferException("read-into", pos, wpos_, len, size());
 			}
 		}
 
@@ -165,61 +230,238 @@ struct ByteBuffer
         void append(const void *src, size_t cnt)
         {
             if (!cnt) return;
-			if (storage_size_< wpos_ + cnt){
+            memcpy(append_space(cnt), src, cnt);
+        }
+
+		//βcntֽڲλãɵ
+		unsigned char *append_space(size_t cnt)
+		{
+			if (storage_size_ - wpos_ < cnt){
 				if (!selfmemory())
-					throw ByteBufferException("out of memeory range", rpos_, wpos_, data_size_);
-				
-				resize( ((wpos_ + cnt+ 1024 )/4096 + 1) * 4096);
-			}
+					throw ByteBufferException("out of memeory range", rpos_, wpos_, cnt, size());
 
-			//COW,дʱָȻֻһcopyд1ô¸һ
-			if (data_ptr_.use_count()>1){
+				resize(grow_capacity(wpos_ + cnt));
+			}
+			else if (shared_storage()){
+				//COW,дʱָȻֻһcopyд1ô¸һ
 				resize(storage_size_);
 			}
-						
-            memcpy(dataptr()+wpos_, src, cnt);
-            wpos_ += cnt;
-        }
+			unsigned char *p = dataptr()+wpos_;
+			wpos_ += cnt;
+			return p;
+		}
+
+		//byte_order_д/ȡһֵ
+		template<typename T>
+		void append_value(T value){
+			if (sizeof(T) > 1 && buf_order_needs_swap(byte_order_))
+				buf_byte_swap(value);
+			append(&value, sizeof(T));
+		}
+
+		template<typename T>
+		void read_value(T &value){
+			read<T>(value);
+			if (sizeof(T) > 1 && buf_order_needs_swap(byte_order_))
+				buf_byte_swap(value);
+		}
 
 		
         void put(size_t pos, const void *src, size_t cnt)
         {
+			if (pos > size() || cnt > size() - pos)
+				throw ByteBufferException("put", pos, wpos_, cnt, size());
+			if (shared_storage()){
+				resize(storage_size_);
+			}
             memcpy(dataptr()+pos, src, cnt);
         }
 		
 		//ʹⲿڴʱstorage_size_ݴС
-		unsigned int size() const{
+		size_t size() const{
 			if (selfmemory()){
-				return data_size_;
+				return wpos_;
 			}
 			return storage_size_;
 		};
 
-		void resize(unsigned int size){
+		//ѷĴ洢ռС
+		size_t capacity() const{
+			return storage_size_;
+		}
+
+		//·洢ռΪsizeֽڣݳֱض
+		void resize(size_t size){
 			if (!selfmemory())
-				throw ByteBufferException("can not resize", rpos_, wpos_, data_size_);
-			boost::shared_ptr<unsigned char> p(new unsigned char[size]);
-			unsigned int copysize = size>=this->size()?this->size():size;
-			if (this->size()){
-				memcpy(p.get(),dataptr(),copysize);
+				throw ByteBufferException("can not resize", rpos_, wpos_, size, this->size());
+
+			size_t copysize = size>=this->size()?this->size():size;
+			if (inline_ptr_ && size <= inline_size_){
+				//ŵʱʹ洢(StaticByteBuffer)
+				if (copysize && raw_data_ptr_ != inline_ptr_){
+					memcpy(inline_ptr_,dataptr(),copysize);
+				}
+				data_ptr_.reset();
+				raw_data_ptr_ = inline_ptr_;
+				storage_size_ = inline_size_;
+				readonly_ = false;
+			}else{
+				boost::shared_ptr<unsigned char> p;
+				if (size){
+					//ܰȡĲҲΪʹ
+					//ȷٹdeleterֵ˳򲻶deleterõȡsize
+					ByteBufferAllocator &a = allocator();
+					unsigned char *mem = a.allocate(size);
+					p.reset(mem, ByteBufferDeleter(&a, size));
+				}
+				if (copysize){
+					memcpy(p.get(),dataptr(),copysize);
+				}
+				data_ptr_ = p;
+				raw_data_ptr_ = data_ptr_.get();
+				storage_size_ = size;
+				readonly_ = false;
 			}
-			data_ptr_ = p;
-			raw_data_ptr_ = data_ptr_.get();
-			storage_size_ = size;
+			if (wpos_ > copysize)
+				wpos_ = copysize;
+			if (rpos_ > copysize)
+				rpos_ = copysize;
+		}
+
+		//֤sizeֽڵĴ洢ռ䣬֮д벻·
+		void reserve(size_t size){
+			if (size > storage_size_)
+				resize(size);
+		}
+
+		//֤֮ٻдnֽڣ԰2ⲿڴ治ݣʲôҲ
+		void reserve_more(size_t n){
+			if (selfmemory() && storage_size_ - wpos_ < n)
+				resize(grow_capacity(wpos_ + n));
+		}
+
+		//ǰĴ洢δʱΪĬϵڴ
+		static ByteBufferAllocator &allocator(){
+			ByteBufferAllocator *a = allocator_slot();
+			return a ? *a : default_allocator();
+		}
+
+		//滻洢Ӧڳʱã0ָĬϡ
+		//ѷĴ洢Ȼķa볤ByteBuffer
+		static void set_allocator(ByteBufferAllocator *a){
+			allocator_slot() = a;
+		}
+
+		//ĬϷBYTEBUFFER_NO_POOLʱֱʹnew[]/delete[]
+		static ByteBufferAllocator &default_allocator(){
+#ifdef BYTEBUFFER_NO_POOL
+			static boost::once_flag s_once = BOOST_ONCE_INIT;
+			boost::call_once(s_once, create_heap_allocator);
+			return *heap_allocator_slot();
+#else
+			return SlabByteBufferAllocator::instance();
+#endif
+		}
+
+		//ͷŶĴ洢ռ
+		void shrink_to_fit(){
+			if (selfmemory() && storage_size_ > size())
+				resize(size());
 		}
 		
 		BYTEBUFFER_OP(char);
 		BYTEBUFFER_OP(unsigned char);
-		BYTEBUFFER_OP(short);
-		BYTEBUFFER_OP(unsigned short);
-		BYTEBUFFER_OP(int);
-		BYTEBUFFER_OP(unsigned int);
-		BYTEBUFFER_OP(long);
-		BYTEBUFFER_OP(unsigned long);
+		BYTEBUFFER_INT_OP(short);
+		BYTEBUFFER_INT_OP(unsigned short);
+		BYTEBUFFER_INT_OP(int);
+		BYTEBUFFER_INT_OP(unsigned int);
+		BYTEBUFFER_INT_OP(long);
+		BYTEBUFFER_INT_OP(unsigned long);
 		BYTEBUFFER_OP(float);
 		BYTEBUFFER_OP(double);
-		BYTEBUFFER_OP(long long);
-		BYTEBUFFER_OP(unsigned long long);
+		BYTEBUFFER_INT_OP(long long);
+		BYTEBUFFER_INT_OP(unsigned long long);
+
+		//varintдvarint_Ӱ
+		template<typename T>
+		void append_varint(T value){
+			unsigned char tmp[10];
+			append(tmp, encode_varint(zigzag(value), tmp));
+		}
+
+		template<typename T>
+		void read_varint(T &value){
+			size_t pos = rpos_;
+			unsigned long long v = read_varint64();
+			//ֵTĿ˵ݲǰTдģ쳣varintλúͳ
+			if ((v >> (sizeof(T) * 8 - 1)) >> 1)
+				throw ByteBufferException("varint overflow", pos, wpos_, rpos_ - pos, size());
+			value = unzigzag<T>(v);
+		}
+
+		//д
+		template<typename T>
+		void append_varints(const T *values, size_t n){
+			unsigned char tmp[10 * 16];
+			while (n){
+				size_t len = 0;
+				for (size_t i = 0; i < 16 && n; i++, n--)
+					len += encode_varint(zigzag(*values++), tmp + len);
+				append(tmp, len);
+			}
+		}
+
+		//ȡ飬8ֵֽʱһδ
+		template<typename T>
+		void get_varints(T *values, size_t n){
+			while (n){
+				const unsigned char *p = contents() + rpos_;
+				if (n >= 8 && size() - rpos_ >= 8){
+					unsigned long long word;
+					memcpy(&word, p, 8);
+					if (!(word & 0x8080808080808080ULL)){
+						for (int i = 0; i < 8; i++)
+							values[i] = unzigzag<T>(p[i]);
+						values += 8;
+						n -= 8;
+						rpos_ += 8;
+						continue;
+					}
+				}
+				read_varint(*values++);
+				n--;
+			}
+		}
+
+		//д鳤ȡַȣvarintģʽwidthֻǷ0β
+		void append_length(size_t len, unsigned int width){
+			if (varint_){
+				append_varint((unsigned long long)len);
+			}else{
+				//ȡwidthֽڣֽֽд
+				unsigned char tmp[8];
+				bool big = length_big_endian();
+				for (unsigned int i = 0; i < width; i++)
+					tmp[big ? width - 1 - i : i] = (unsigned char)((unsigned long long)len >> (8 * i));
+				append(tmp, width);
+			}
+		}
+
+		size_t read_length(unsigned int width){
+			if (varint_){
+				unsigned long long n;
+				read_varint(n);
+				if (n > size())
+					throw ByteBufferException("length", rpos_, wpos_, (size_t)n, size());
+				return (size_t)n;
+			}
+			const unsigned char *p = read_bytes(width);
+			bool big = length_big_endian();
+			unsigned long long n = 0;
+			for (unsigned int i = 0; i < width; i++)
+				n |= (unsigned long long)p[big ? width - 1 - i : i] << (8 * i);
+			return (size_t)n;
+		}
 
 		ByteBuffer &operator<<(bool value)
 		{
@@ -231,10 +473,70 @@ struct ByteBuffer
 		template<typename T,size_t N>
 		ByteBuffer  &operator<<(T (&v)[N])
 		{
-			append((unsigned char *)v,sizeof(v));
+			append_array(v,N,buf_blittable<T>());
 			return *this;
 		}
 
+		//飬ûгǰ׺varintģʽҲֶ
+		template<typename T>
+		void append_array(const T *v,size_t n,boost::true_type){
+			if (sizeof(T) > 1 && buf_order_needs_swap(byte_order_)){
+				if (n)
+					buf_swap_array(append_space(n*sizeof(T)),v,n,sizeof(T));
+			}else{
+				append((unsigned char *)v,n*sizeof(T));
+			}
+		}
+
+		template<typename T>
+		void append_array(const T *v,size_t n,boost::false_type){
+			append_array_pod(v,n,boost::is_pod<T>());
+		}
+
+		//POD(ṹ)ڴԭƣֽڣֽӰ
+		template<typename T>
+		void append_array_pod(const T *v,size_t n,boost::true_type){
+			append((unsigned char *)v,n*sizeof(T));
+		}
+
+		template<typename T>
+		void append_array_pod(const T *v,size_t n,boost::false_type){
+			for (size_t i=0;i<n;i++)
+				*this<<v[i];
+		}
+
+		template<typename T>
+		void get_array(T *v,size_t n,boost::true_type){
+			get((unsigned char *)v,n*sizeof(T));
+			if (sizeof(T) > 1 && buf_order_needs_swap(byte_order_))
+				buf_swap_array(v,v,n,sizeof(T));
+		}
+
+		template<typename T>
+		void get_array(T *v,size_t n,boost::false_type){
+			get_array_pod(v,n,boost::is_pod<T>());
+		}
+
+		template<typename T>
+		void get_array_pod(T *v,size_t n,boost::true_type){
+			get((unsigned char *)v,n*sizeof(T));
+		}
+
+		template<typename T>
+		void get_array_pod(T *v,size_t n,boost::false_type){
+			for (size_t i=0;i<n;i++)
+				*this>>v[i];
+		}
+
+		//鲢lenֽڣǵʼλ
+		const unsigned char *read_bytes(size_t len){
+			if (len > size() - rpos_)
+				throw ByteBufferException("read-bytes", rpos_, wpos_, len, size());
+			const unsigned char *p = contents() + rpos_;
+			rpos_ += len;
+			return p;
+		}
+
 
 		template<class T>
 		ByteBuffer &append(const T& value)
@@ -258,7 +560,7 @@ struct ByteBuffer
 		template<typename T,size_t N>
 		ByteBuffer  &operator>>(T (&v)[N])
 		{
-			get((unsigned char *)v,sizeof(v));
+			get_array(v,N,buf_blittable<T>());
 			return *this;
 		}
 
@@ -269,12 +571,27 @@ protected:
 
 		template <typename T>  void read(T & value,size_t pos) const
 		{
-			if(pos + sizeof(T) > size())
-				throw ByteBufferException("read", pos, wpos_, sizeof(T), data_size_);
-			value=*((T*)(contents()+pos));
+			if(pos > size() || sizeof(T) > size() - pos)
+				throw ByteBufferException("read", pos, wpos_, sizeof(T), size());
+			memcpy(&value, contents()+pos, sizeof(T));
 		}
+		//StaticByteBufferinline_bufṩʱʹöڴ
+		struct inline_storage_tag{};
+		ByteBuffer(unsigned char *inline_buf,size_t size,inline_storage_tag){
+			init();
+			inline_ptr_ = inline_buf;
+			inline_size_ = size;
+			raw_data_ptr_ = inline_buf;
+			storage_size_ = size;
+		}
+
+		//洢ͱĶֻдǰҪȸ
+		bool shared_storage() const{
+			return readonly_ || data_ptr_.use_count()>1;
+		}
+
 		bool selfmemory() const{
-			if (data_ptr_!=NULL || !raw_data_ptr_){
+			if (data_ptr_!=NULL || !raw_data_ptr_ || raw_data_ptr_==inline_ptr_){
 				return true;
 			}
 			return false;
@@ -283,16 +600,106 @@ protected:
 		unsigned char * dataptr() const{
 			return (unsigned char *)raw_data_ptr_;
 		};
+
+		void init(){
+			rpos_=0;
+			wpos_=0;
+			raw_data_ptr_=0;
+			storage_size_=0;
+			inline_ptr_=0;
+			inline_size_=0;
+			readonly_=false;
+			array_with_bytes_=BUF_VEC_WIDTH;
+			varint_=false;
+			byte_order_=BYTEBUFFER_DEFAULT_BYTE_ORDER;
+		}
+
+		bool length_big_endian() const{
+			return byte_order_ == BUF_BIG_ENDIAN || (byte_order_ == BUF_HOST_ORDER && buf_host_is_big_endian());
+		}
+
+		template<typename T>
+		static unsigned long long zigzag(T v){
+			if (std::numeric_limits<T>::is_signed){
+				unsigned long long u = (unsigned long long)(long long)v;
+				return (u << 1) ^ (unsigned long long)((long long)v >> 63);
+			}
+			return (unsigned long long)v;
+		}
+
+		template<typename T>
+		static T unzigzag(unsigned long long u){
+			if (std::numeric_limits<T>::is_signed)
+				return (T)(long long)((u >> 1) ^ (0 - (u & 1)));
+			return (T)u;
+		}
+
+		static size_t encode_varint(unsigned long long v, unsigned char *out){
+			size_t n = 0;
+			while (v >= 0x80){
+				out[n++] = (unsigned char)(v | 0x80);
+				v >>= 7;
+			}
+			out[n++] = (unsigned char)v;
+			return n;
+		}
+
+		unsigned long long read_varint64(){
+			const unsigned char *p = contents() + rpos_;
+			size_t avail = size() - rpos_;
+			unsigned long long v = 0;
+			if (avail >= 10){
+				//ٻ10ֽڣֽڼ߽
+				for (size_t i = 0; i < 10; i++){
+					v |= (unsigned long long)(p[i] & 0x7f) << (7 * i);
+					if (!(p[i] & 0x80)){
+						rpos_ += i + 1;
+						return v;
+					}
+				}
+			}else{
+				for (size_t i = 0; i < avail; i++){
+					v |= (unsigned long long)(p[i] & 0x7f) << (7 * i);
+					if (!(p[i] & 0x80)){
+						rpos_ += i + 1;
+						return v;
+					}
+				}
+			}
+			throw ByteBufferException("varint", rpos_, wpos_, avail < 10 ? avail + 1 : 10, size());
+		}
+
+		static ByteBufferAllocator *&allocator_slot(){
+			static ByteBufferAllocator *s_allocator = 0;
+			return s_allocator;
+		}
+
+#ifdef BYTEBUFFER_NO_POOL
+		static HeapByteBufferAllocator *&heap_allocator_slot(){
+			static HeapByteBufferAllocator *s_heap = 0;
+			return s_heap;
+		}
+
+		static void create_heap_allocator(){
+			heap_allocator_slot() = new HeapByteBufferAllocator();
+		}
+#endif
+
+		//2nappendֻҪO(log n)·
+		size_t grow_capacity(size_t need) const{
+			size_t cap = storage_size_ < BUF_MIN_CAPACITY / 2 ? BUF_MIN_CAPACITY : storage_size_ * 2;
+			return cap < need ? need : cap;
+		}
 		
 		boost::shared_ptr<unsigned char> data_ptr_;
 		
 		size_t	rpos_;
-		union{
-			unsigned int	data_size_;			//ݴС
-			size_t	wpos_;				//дλ
-		};
+		size_t	wpos_;					//дλãڴʱҲݴС
         unsigned char *	raw_data_ptr_;
-		unsigned int  storage_size_;		//洢ռС
+		size_t  storage_size_;			//洢ռС
+		unsigned char *	inline_ptr_;	//洢
+		size_t	inline_size_;
+		bool	readonly_;				//data_ptr_ָֻڴ棬shared_storage()
 public:
 
 	//ÿ
@@ -302,50 +709,142 @@ public:
 	template <int N> ByteBuffer &operator<<(vec_head_size<N> w){	array_with_bytes_ = N;return *this;}
 	template <int N> ByteBuffer &operator>>(vec_head_size<N> w){	array_with_bytes_ = N;return *this;}
 
+	//ͳʹvarint룬 b << ByteBuffer::varint_mode<true>()
+	template<bool ON>
+	struct	varint_mode{
+	};
+	template <bool ON> ByteBuffer &operator<<(varint_mode<ON> m){	varint_ = ON;return *this;}
+	template <bool ON> ByteBuffer &operator>>(varint_mode<ON> m){	varint_ = ON;return *this;}
+
+	//ֵֽֽ b << ByteBuffer::byte_order<BUF_BIG_ENDIAN>()
+	template<int ORDER>
+	struct	byte_order{
+	};
+	template <int ORDER> ByteBuffer &operator<<(byte_order<ORDER> o){	byte_order_ = ORDER;return *this;}
+	template <int ORDER> ByteBuffer &operator>>(byte_order<ORDER> o){	byte_order_ = ORDER;return *this;}
+
 	unsigned char	array_with_bytes_;		//ڴ洢ʱڱʾСҪֽĬΪ1
+	bool			varint_;				//ֽͳȰvarint洢
+	unsigned char	byte_order_;			//buf_byte_orderĬBYTEBUFFER_DEFAULT_BYTE_ORDER
 
 public:
 	template<class _Type,class T2,class T3>
 	ByteBuffer &operator<<(const std::basic_string<_Type,T2,T3> &s)
 	{
-		if (array_with_bytes_){
-			unsigned int len = s.size();
-			append(&len,array_with_bytes_);
-			append((unsigned char *)s.c_str(),s.size()*sizeof(_Type));
-		}else{
-			append((unsigned char *)s.c_str(),s.size()*sizeof(_Type)+sizeof(_Type));
-		}
+		append_string(s.c_str(),s.size());
 		return *this;
 	}
 
-
 	template<class _Type,class T2,class T3>
 	ByteBuffer &operator>>(std::basic_string<_Type,T2,T3>& s)
 	{
-		s.clear();
+		size_t len;
+		const _Type *p=read_string_ref<_Type>(len);
+		s.assign(p,len);
+		return *this;
+	}
+
+	/*
+	string_ref/string_view/spanָ򻺳ڲơЧڣ
+		- ڴ棺洢ͷŻ·֮ǰԱд(append/put/resize)
+		  ·򴥷COW֮ЧһByteBufferԹ̶洢
+		- ⲿڴ(ByteBuffer(data,size,false))ByteBuffer޹أֻҪߵdataЧ
+		- StaticByteBuffer洢ֻڸöδ޸ڼЧ
+	*/
+	template<class _Type,class T>
+	ByteBuffer &operator<<(const boost::basic_string_ref<_Type,T> &s)
+	{
+		append_string(s.data(),s.size());
+		return *this;
+	}
+
+	template<class _Type,class T>
+	ByteBuffer &operator>>(boost::basic_string_ref<_Type,T> &s)
+	{
+		size_t len;
+		const _Type *p=read_string_ref<_Type>(len);
+		s=boost::basic_string_ref<_Type,T>(p,len);
+		return *this;
+	}
+
+#ifdef BYTEBUFFER_HAS_STRING_VIEW
+	template<class _Type,class T>
+	ByteBuffer &operator<<(const std::basic_string_view<_Type,T> &s)
+	{
+		append_string(s.data(),s.size());
+		return *this;
+	}
+
+	template<class _Type,class T>
+	ByteBuffer &operator>>(std::basic_string_view<_Type,T> &s)
+	{
+		size_t len;
+		const _Type *p=read_string_ref<_Type>(len);
+		s=std::basic_string_view<_Type,T>(p,len);
+		return *this;
+	}
+#endif
+
+#ifdef BYTEBUFFER_HAS_SPAN
+	//ֱֻֿ֧ӸƵԪأҪҪתֽ򡢲varint롢ַ
+	template<class T>
+	ByteBuffer &operator>>(std::span<const T> &v)
+	{
+		static_assert(buf_blittable<T>::value, "span<const T> needs a blittable T");
+		if ((varint_ && buf_varint_type<T>::value) || (sizeof(T) > 1 && buf_order_needs_swap(byte_order_)))
+			throw ByteBufferException("span-encoding", rpos_, wpos_, 0, size());
+		size_t vsize=read_length(array_with_bytes_);
+		if (vsize > (size()-rpos_)/sizeof(T))
+			throw ByteBufferException("read-span", rpos_, wpos_, vsize*sizeof(T), size());
+		const unsigned char *p=contents()+rpos_;
+		if ((size_t)p % alignof(T))
+			throw ByteBufferException("span-align", rpos_, wpos_, vsize*sizeof(T), size());
+		rpos_+=vsize*sizeof(T);
+		v=std::span<const T>((const T *)p,vsize);
+		return *this;
+	}
+#endif
+
+	//array_with_bytes_дַгǰ׺0β
+	template<class _Type>
+	void append_string(const _Type *p,size_t len)
+	{
 		if (array_with_bytes_){
-			unsigned int len=0;
-			get((unsigned char *)&len,array_with_bytes_);
-			s.resize(len);
-			get(const_cast<unsigned char*>((const unsigned char *)s.c_str()),len*sizeof(_Type));
+			append_length(len,array_with_bytes_);
+			append((unsigned char *)p,len*sizeof(_Type));
 		}else{
-			while (true)
-			{
-				_Type c=read<_Type>();
-				if (c==0)
-					break;
-				s+=c;
-			}
+			append((unsigned char *)p,len*sizeof(_Type));
+			_Type zero=_Type();
+			append(&zero,sizeof(_Type));
 		}
-		return *this;
+	}
+
+	//һַڻеλãlenΪַ(β0)
+	template<class _Type>
+	const _Type *read_string_ref(size_t &len)
+	{
+		if (array_with_bytes_){
+			len=read_length(array_with_bytes_);
+			if (len > (size()-rpos_)/sizeof(_Type))
+				throw ByteBufferException("read-string", rpos_, wpos_, len*sizeof(_Type), size());
+			return (const _Type *)read_bytes(len*sizeof(_Type));
+		}
+		//0βmemchr/wmemchrҵβ
+		const _Type *p=(const _Type *)(contents()+rpos_);
+		const _Type *z=std::char_traits<_Type>::find(p,(size()-rpos_)/sizeof(_Type),_Type());
+		if (!z)
+			throw ByteBufferException("read-string", rpos_, wpos_, size()-rpos_+sizeof(_Type), size());
+		len=z-p;
+		rpos_+=(len+1)*sizeof(_Type);
+		return p;
 	}
 
 	inline ByteBuffer &operator<<(const char * s)
 	{
 		if (array_with_bytes_){
-			unsigned int len = strlen(s);
-			append(&len,array_with_bytes_);
-			append((unsigned char *)s,strlen(s));
+			size_t len = strlen(s);
+			append_length(len,array_with_bytes_);
+			append((unsigned char *)s,len);
 		}else{
 			append((unsigned char *)s,strlen(s)+1);
 		}
@@ -355,37 +854,71 @@ public:
 	inline ByteBuffer &operator>>(char * s)
 	{	
 		if (array_with_bytes_){
-			unsigned int len=0;
-			get((unsigned char *)&len,array_with_bytes_);
+			size_t len=read_length(array_with_bytes_);
 			get((unsigned char *)s,len);
 			s[len]=0;
 		}else{
-			while (true)
-			{
-				*s++=read<char>();
-				if (*s==0)
-					break;
-			}
+			const char *p=(const char *)(contents()+rpos_);
+			const char *z=(const char *)memchr(p,0,size()-rpos_);
+			if (!z)
+				throw ByteBufferException("read-string", rpos_, wpos_, size()-rpos_+1, size());
+			memcpy(s,p,z-p+1);
+			rpos_+=z-p+1;
 		}
 		return *this;
 	}
 
 };
 
+/*
+ջ()洢ByteBufferNֽʱڴ棬ԶתΪڴ档
+нByteBuffer&ĵط(DEC_BUF_OPл)
+*/
+template<size_t N>
+struct StaticByteBuffer : public ByteBuffer
+{
+	StaticByteBuffer()
+		: ByteBuffer(inline_data_,N,inline_storage_tag()){
+	}
+
+	StaticByteBuffer(const ByteBuffer& b)
+		: ByteBuffer(inline_data_,N,inline_storage_tag()){
+		ByteBuffer::operator=(b);
+	}
+
+	StaticByteBuffer(const StaticByteBuffer& b)
+		: ByteBuffer(inline_data_,N,inline_storage_tag()){
+		ByteBuffer::operator=(b);
+	}
+
+	StaticByteBuffer &operator=(const ByteBuffer& b){
+		ByteBuffer::operator=(b);
+		return *this;
+	}
+
+	StaticByteBuffer &operator=(const StaticByteBuffer& b){
+		ByteBuffer::operator=(b);
+		return *this;
+	}
+
+	//Ƿ洢
+	bool is_inline() const{
+		return contents()==inline_data_;
+	}
+
+private:
+	unsigned char inline_data_[N];
+};
+
 /*
 һ
 */
 template<class _RanIt> inline
 ByteBuffer & vecpack(_RanIt _First, _RanIt _Last,ByteBuffer &b,unsigned int size_width=BUF_VEC_WIDTH){
-	unsigned int bpos = b.wpos();
-	size_t num=0 ;
-	b.append((unsigned char *)&num,size_width);
-	
+	b.append_length(std::distance(_First,_Last),size_width);
 	for (_RanIt it=_First;it!=_Last;it++){
 		b<<*it;
-		num++;
 	}
-	b.put(bpos,&num,size_width);
 	return b;
 }
 
@@ -395,11 +928,10 @@ ByteBuffer & vecpack(_RanIt _First, _RanIt _Last,ByteBuffer &b,unsigned int size
 template<typename T>
 ByteBuffer & vecdepack(T& container,ByteBuffer &b,unsigned int size_width=BUF_VEC_WIDTH){
 	
-	unsigned int vsize=0;
-	b.get((unsigned char *)&vsize,size_width);
+	size_t vsize=b.read_length(size_width);
 	container.clear();
 	container.resize(vsize);
-	for (T::iterator it = container.begin();it!=container.end();it++){
+	for (typename T::iterator it = container.begin();it!=container.end();it++){
 		 b>> *it;
 	}
 	//for (unsigned int i=0;i<vsize;i++){
@@ -408,79 +940,315 @@ ByteBuffer & vecdepack(T& container,ByteBuffer &b,unsigned int size_width=BUF_VE
 	return b;
 }
 
-template <typename T> ByteBuffer &operator<<(ByteBuffer &b,const std::set<T>& s)
+//ֱӸƵԪд룺һγȼ飬һmemcpy
+template <typename T> void vecpack_bulk(ByteBuffer &b,const std::vector<T>& v,boost::true_type)
+{
+	b.append_length(v.size(),b.array_with_bytes_);
+	if (!v.empty())
+		b.append_array(&v[0],v.size(),boost::true_type());
+}
+
+template <typename T> void vecpack_bulk(ByteBuffer &b,const std::vector<T>& v,boost::false_type)
+{
+	vecpack(v.begin(),v.end(),b,b.array_with_bytes_);
+}
+
+template <typename T> void vecdepack_bulk(ByteBuffer &b,std::vector<T>& v,boost::true_type)
+{
+	size_t vsize=b.read_length(b.array_with_bytes_);
+	if (vsize > (b.size()-b.rpos())/sizeof(T))
+		throw ByteBufferException("read-vector", b.rpos(), b.wpos(), vsize*sizeof(T), b.size());
+	//еλòһT룬ֽڸƣҪֽʱƵͬʱ
+	v.resize(vsize);
+	if (!vsize)
+		return;
+	const unsigned char *p=b.read_bytes(vsize*sizeof(T));
+	if (sizeof(T) > 1 && buf_order_needs_swap(b.byte_order_))
+		buf_swap_array(&v[0],p,vsize,sizeof(T));
+	else
+		memcpy(&v[0],p,vsize*sizeof(T));
+}
+
+template <typename T> void vecdepack_bulk(ByteBuffer &b,std::vector<T>& v,boost::false_type)
+{
+	vecdepack(v,b,b.array_with_bytes_);
+}
+
+//varintģʽµ
+template <typename T> void vecpack_varint(ByteBuffer &b,const std::vector<T>& v,boost::true_type)
+{
+	b.append_length(v.size(),b.array_with_bytes_);
+	if (!v.empty())
+		b.append_varints(&v[0],v.size());
+}
+
+template <typename T> void vecpack_varint(ByteBuffer &b,const std::vector<T>& v,boost::false_type)
+{
+	vecpack_bulk(b,v,buf_blittable<T>());
+}
+
+template <typename T> void vecdepack_varint(ByteBuffer &b,std::vector<T>& v,boost::true_type)
+{
+	size_t vsize=b.read_length(b.array_with_bytes_);
+	v.resize(vsize);
+	if (vsize)
+		b.get_varints(&v[0],vsize);
+}
+
+template <typename T> void vecdepack_varint(ByteBuffer &b,std::vector<T>& v,boost::false_type)
+{
+	vecdepack_bulk(b,v,buf_blittable<T>());
+}
+
+template <typename T> ByteBuffer &operator<<(ByteBuffer &b,const std::vector<T>& v)
+{
+	if (b.varint_)
+		vecpack_varint(b,v,buf_varint_type<T>());
+	else
+		vecpack_bulk(b,v,buf_blittable<T>());
+	return b;
+}
+
+template <typename T> ByteBuffer &operator>>(ByteBuffer &b, std::vector<T> &v)
+{
+	if (b.varint_)
+		vecdepack_varint(b,v,buf_varint_type<T>());
+	else
+		vecdepack_bulk(b,v,buf_blittable<T>());
+	return b;
+}
+
+//飬Cһûгǰ׺
+template <typename T, size_t N> ByteBuffer &operator<<(ByteBuffer &b,const boost::array<T,N>& v)
+{
+	if (N)
+		b.append_array(&v[0],N,buf_blittable<T>());
+	return b;
+}
+
+template <typename T, size_t N> ByteBuffer &operator>>(ByteBuffer &b, boost::array<T,N> &v)
+{
+	if (N)
+		b.get_array(&v[0],N,buf_blittable<T>());
+	return b;
+}
+
+template <typename T, size_t N> ByteBuffer &operator<<(ByteBuffer &b,const std::array<T,N>& v)
+{
+	if (N)
+		b.append_array(&v[0],N,buf_blittable<T>());
+	return b;
+}
+
+template <typename T, size_t N> ByteBuffer &operator>>(ByteBuffer &b, std::array<T,N> &v)
+{
+	if (N)
+		b.get_array(&v[0],N,buf_blittable<T>());
+	return b;
+}
+
+template <typename T> ByteBuffer &operator<<(ByteBuffer &b,const std::list<T>& v)
+{
+     vecpack(v.begin(),v.end(),b,b.array_with_bytes_);
+	  return b;
+}
+
+template <typename T> ByteBuffer &operator>>(ByteBuffer &b, std::list<T> &v)
+{
+	vecdepack(v,b,b.array_with_bytes_);
+	return b;
+}
+
+
+/*
+дԪظ(unsigned int)дԪء
+˳дʱĩβʾ룬Եģ
+unorderedreserveflat_map/flat_setȶһι
+*/
+inline size_t buf_read_count(ByteBuffer &b)
+{
+	unsigned int n;
+	b >> n;
+	//ÿԪ1ֽڣֹĸ´
+	if (n > b.size() - b.rpos())
+		throw ByteBufferException("read-count", b.rpos(), b.wpos(), n, b.size());
+	return n;
+}
+
+template <typename S> ByteBuffer &buf_pack_set(ByteBuffer &b,const S& s)
 {
 	b << (unsigned int)s.size();
-	for (typename std::set<T>::const_iterator i = s.begin(); i != s.end(); i++)
+	for (typename S::const_iterator i = s.begin(); i != s.end(); i++)
 	{
 		b << *i;
 	}
 	return b;
 }
 
-template <typename T> ByteBuffer &operator>>(ByteBuffer &b, std::set<T> &s)
+template <typename M> ByteBuffer &buf_pack_map(ByteBuffer &b,const M& m)
+{
+	b << (unsigned int)m.size();
+	for (typename M::const_iterator i = m.begin(); i != m.end(); i++)
+	{
+		b << i->first << i->second;
+	}
+	return b;
+}
+
+//ʱÿβO(1)
+template <typename S> ByteBuffer &buf_unpack_set(ByteBuffer &b, S &s)
 {
-	unsigned int ssize;
-	b >> ssize;
+	size_t n = buf_read_count(b);
 	s.clear();
-	while(ssize--)
+	while (n--)
 	{
-		T t;
+		typename S::value_type t;
 		b >> t;
-		s.insert(t);
+		s.insert(s.end(), std::move(t));
 	}
 	return b;
 }
 
-template <typename T> ByteBuffer &operator<<(ByteBuffer &b,const std::vector<T>& v)
+template <typename M> ByteBuffer &buf_unpack_map(ByteBuffer &b, M &m)
 {
-    vecpack(v.begin(),v.end(),b,b.array_with_bytes_);
+	size_t n = buf_read_count(b);
+	m.clear();
+	while (n--)
+	{
+		typename M::key_type k;
+		typename M::mapped_type v;
+		b >> k >> v;
+		m.emplace_hint(m.end(), std::move(k), std::move(v));
+	}
 	return b;
 }
 
-template <typename T> ByteBuffer &operator>>(ByteBuffer &b, std::vector<T> &v)
+template <typename S> ByteBuffer &buf_unpack_unordered_set(ByteBuffer &b, S &s)
 {
-   vecdepack(v,b,b.array_with_bytes_);
+	size_t n = buf_read_count(b);
+	s.clear();
+	s.reserve(n);
+	while (n--)
+	{
+		typename S::value_type t;
+		b >> t;
+		s.insert(std::move(t));
+	}
 	return b;
 }
 
-template <typename T> ByteBuffer &operator<<(ByteBuffer &b,const std::list<T>& v)
+template <typename M> ByteBuffer &buf_unpack_unordered_map(ByteBuffer &b, M &m)
 {
-     vecpack(v.begin(),v.end(),b,b.array_with_bytes_);
-	  return b;
+	size_t n = buf_read_count(b);
+	m.clear();
+	m.reserve(n);
+	while (n--)
+	{
+		typename M::key_type k;
+		typename M::mapped_type v;
+		b >> k >> v;
+		m.emplace(std::move(k), std::move(v));
+	}
+	return b;
 }
 
-template <typename T> ByteBuffer &operator>>(ByteBuffer &b, std::list<T> &v)
+//flat飬ҲظʱֱӲã򽻸
+template <typename S> ByteBuffer &buf_unpack_flat_set(ByteBuffer &b, S &s)
 {
-	vecdepack(v,b,b.array_with_bytes_);
+	size_t n = buf_read_count(b);
+	std::vector<typename S::value_type> v(n);
+	for (size_t i = 0; i < n; i++)
+		b >> v[i];
+	s.clear();
+	typename S::value_compare less = s.value_comp();
+	bool ordered = true;
+	for (size_t i = 1; i < n && ordered; i++)
+		ordered = less(v[i - 1], v[i]);
+	if (ordered)
+		s.insert(boost::container::ordered_unique_range, v.begin(), v.end());
+	else
+		s.insert(v.begin(), v.end());
 	return b;
 }
 
+template <typename M> ByteBuffer &buf_unpack_flat_map(ByteBuffer &b, M &m)
+{
+	size_t n = buf_read_count(b);
+	std::vector<std::pair<typename M::key_type, typename M::mapped_type> > v(n);
+	for (size_t i = 0; i < n; i++)
+		b >> v[i].first >> v[i].second;
+	m.clear();
+	typename M::key_compare less = m.key_comp();
+	bool ordered = true;
+	for (size_t i = 1; i < n && ordered; i++)
+		ordered = less(v[i - 1].first, v[i].first);
+	if (ordered)
+		m.insert(boost::container::ordered_unique_range, v.begin(), v.end());
+	else
+		m.insert(v.begin(), v.end());
+	return b;
+}
 
-template <typename K, typename V,typename F> ByteBuffer &operator<<(ByteBuffer &b,const std::map<K, V,F> &m)
+template <typename T, typename C, typename A> ByteBuffer &operator<<(ByteBuffer &b,const std::set<T,C,A>& s)
 {
-    b << (unsigned int)m.size();
-    for (typename std::map<K, V,F>::const_iterator i = m.begin(); i != m.end(); i++)
-    {
-        b << i->first << i->second;
-    }
-    return b;
+	return buf_pack_set(b,s);
 }
 
-template <typename K, typename V,typename F> ByteBuffer &operator>>(ByteBuffer &b, std::map<K, V,F> &m)
+template <typename T, typename C, typename A> ByteBuffer &operator>>(ByteBuffer &b, std::set<T,C,A> &s)
 {
-    unsigned int msize;
-    b >> msize;
-    m.clear();
-    while(msize--)
-    {
-        K k;
-        V v;
-        b >> k >> v;
-        m.insert(make_pair(k, v));
-    }
-    return b;
+	return buf_unpack_set(b,s);
+}
+
+template <typename K, typename V, typename F, typename A> ByteBuffer &operator<<(ByteBuffer &b,const std::map<K,V,F,A> &m)
+{
+	return buf_pack_map(b,m);
+}
+
+template <typename K, typename V, typename F, typename A> ByteBuffer &operator>>(ByteBuffer &b, std::map<K,V,F,A> &m)
+{
+	return buf_unpack_map(b,m);
+}
+
+template <typename T, typename H, typename E, typename A> ByteBuffer &operator<<(ByteBuffer &b,const std::unordered_set<T,H,E,A>& s)
+{
+	return buf_pack_set(b,s);
+}
+
+template <typename T, typename H, typename E, typename A> ByteBuffer &operator>>(ByteBuffer &b, std::unordered_set<T,H,E,A> &s)
+{
+	return buf_unpack_unordered_set(b,s);
+}
+
+template <typename K, typename V, typename H, typename E, typename A> ByteBuffer &operator<<(ByteBuffer &b,const std::unordered_map<K,V,H,E,A> &m)
+{
+	return buf_pack_map(b,m);
+}
+
+template <typename K, typename V, typename H, typename E, typename A> ByteBuffer &operator>>(ByteBuffer &b, std::unordered_map<K,V,H,E,A> &m)
+{
+	return buf_unpack_unordered_map(b,m);
 }
+
+template <typename T, typename C, typename A> ByteBuffer &operator<<(ByteBuffer &b,const boost::container::flat_set<T,C,A>& s)
+{
+	return buf_pack_set(b,s);
+}
+
+template <typename T, typename C, typename A> ByteBuffer &operator>>(ByteBuffer &b, boost::container::flat_set<T,C,A> &s)
+{
+	return buf_unpack_flat_set(b,s);
+}
+
+template <typename K, typename V, typename C, typename A> ByteBuffer &operator<<(ByteBuffer &b,const boost::container::flat_map<K,V,C,A> &m)
+{
+	return buf_pack_map(b,m);
+}
+
+template <typename K, typename V, typename C, typename A> ByteBuffer &operator>>(ByteBuffer &b, boost::container::flat_map<K,V,C,A> &m)
+{
+	return buf_unpack_flat_map(b,m);
+}
+
 template <typename T1, typename T2> ByteBuffer &operator<<(ByteBuffer &b,const std::pair<T1,T2> &p)
 {
 	b << p.first<<p.second;
@@ -496,43 +1264,233 @@ template <typename T1, typename T2> ByteBuffer &operator>>(ByteBuffer &b, std::p
 
 
 
+/*
+ֶблDEC_BUF_OPnBUF_FIELDSչbuf_pack_fields/buf_unpack_fields
+	- ֶζǶ(ֱӸƵͻbool)ҲvarintģʽʱСڱȷ
+	  дʱֻһοռ䣬ȡʱֻһγ
+	- ȹСԤռ䣬ֶζдǶ׽ṹʹøԵoperator<<
+*/
+template<typename T>
+struct buf_fixed_field : boost::integral_constant<bool,
+	buf_blittable<T>::value || boost::is_same<typename boost::remove_cv<T>::type, bool>::value>
+{
+};
+
+template<typename... T>
+struct buf_fields_fixed;
+
+template<>
+struct buf_fields_fixed<>
+{
+	static const bool value = true;
+	static const size_t size = 0;
+};
+
+template<typename T, typename... R>
+struct buf_fields_fixed<T, R...>
+{
+	static const bool value = buf_fixed_field<T>::value && buf_fields_fixed<R...>::value;
+	static const size_t size = sizeof(T) + buf_fields_fixed<R...>::size;
+};
+
+template<typename T>
+inline void buf_put_fixed(unsigned char *&p, bool swap, const T &v)
+{
+	T x = v;
+	if (sizeof(T) > 1 && swap)
+		buf_byte_swap(x);
+	memcpy(p, &x, sizeof(T));
+	p += sizeof(T);
+}
+
+inline void buf_put_fixed(unsigned char *&p, bool swap, const bool &v)
+{
+	*p++ = v ? 1 : 0;
+}
+
+template<typename T>
+inline void buf_get_fixed(const unsigned char *&p, bool swap, T &v)
+{
+	memcpy(&v, p, sizeof(T));
+	if (sizeof(T) > 1 && swap)
+		buf_byte_swap(v);
+	p += sizeof(T);
+}
+
+inline void buf_get_fixed(const unsigned char *&p, bool swap, bool &v)
+{
+	v = (char)*p++ > 0;
+}
+
+inline void buf_put_fields(unsigned char *&p, bool swap)
+{
+}
+
+template<typename T, typename... R>
+inline void buf_put_fields(unsigned char *&p, bool swap, const T &t, const R &... r)
+{
+	buf_put_fixed(p, swap, t);
+	buf_put_fields(p, swap, r...);
+}
+
+inline void buf_get_fields(const unsigned char *&p, bool swap)
+{
+}
+
+template<typename T, typename... R>
+inline void buf_get_fields(const unsigned char *&p, bool swap, T &t, R &... r)
+{
+	buf_get_fixed(p, swap, t);
+	buf_get_fields(p, swap, r...);
+}
+
+inline void buf_pack_each(ByteBuffer &b)
+{
+}
+
+template<typename T, typename... R>
+inline void buf_pack_each(ByteBuffer &b, const T &t, const R &... r)
+{
+	b << t;
+	buf_pack_each(b, r...);
+}
+
+inline void buf_unpack_each(ByteBuffer &b)
+{
+}
+
+template<typename T, typename... R>
+inline void buf_unpack_each(ByteBuffer &b, T &t, R &... r)
+{
+	b >> t;
+	buf_unpack_each(b, r...);
+}
+
+//ԤռõĴСƣҪȷ
+template<typename T>
+inline size_t buf_field_size(const T &t)
+{
+	return buf_fixed_field<T>::value ? sizeof(T) : 0;
+}
+
+template<class _Type,class T2,class T3>
+inline size_t buf_field_size(const std::basic_string<_Type,T2,T3> &s)
+{
+	return sizeof(unsigned int) + s.size() * sizeof(_Type);
+}
+
+template<typename T>
+inline size_t buf_field_size(const std::vector<T> &v)
+{
+	return sizeof(unsigned int) + v.size() * (buf_fixed_field<T>::value ? sizeof(T) : 1);
+}
+
+inline size_t buf_fields_size()
+{
+	return 0;
+}
+
+template<typename T, typename... R>
+inline size_t buf_fields_size(const T &t, const R &... r)
+{
+	return buf_field_size(t) + buf_fields_size(r...);
+}
+
+template<typename... T>
+inline void buf_pack_dispatch(ByteBuffer &b, boost::true_type, const T &... fields)
+{
+	if (b.varint_){
+		b.reserve_more(buf_fields_fixed<T...>::size);
+		buf_pack_each(b, fields...);
+		return;
+	}
+	unsigned char *p = b.append_space(buf_fields_fixed<T...>::size);
+	buf_put_fields(p, buf_order_needs_swap(b.byte_order_), fields...);
+}
+
+template<typename... T>
+inline void buf_pack_dispatch(ByteBuffer &b, boost::false_type, const T &... fields)
+{
+	b.reserve_more(buf_fields_size(fields...));
+	buf_pack_each(b, fields...);
+}
+
+template<typename... T>
+inline void buf_unpack_dispatch(ByteBuffer &b, boost::true_type, T &... fields)
+{
+	if (b.varint_){
+		buf_unpack_each(b, fields...);
+		return;
+	}
+	const unsigned char *p = b.read_bytes(buf_fields_fixed<T...>::size);
+	buf_get_fields(p, buf_order_needs_swap(b.byte_order_), fields...);
+}
+
+template<typename... T>
+inline void buf_unpack_dispatch(ByteBuffer &b, boost::false_type, T &... fields)
+{
+	buf_unpack_each(b, fields...);
+}
+
+template<typename... T>
+inline ByteBuffer &buf_pack_fields(ByteBuffer &b, const T &... fields)
+{
+	buf_pack_dispatch(b, boost::integral_constant<bool, buf_fields_fixed<T...>::value>(), fields...);
+	return b;
+}
+
+template<typename... T>
+inline ByteBuffer &buf_unpack_fields(ByteBuffer &b, T &... fields)
+{
+	buf_unpack_dispatch(b, boost::integral_constant<bool, buf_fields_fixed<T...>::value>(), fields...);
+	return b;
+}
+
+/*
+ڽṹҪлֶΣڽṹDEC_BUF_FIELDSoperator<<>>
+	struct Foo{ int a; std::string s; BUF_FIELDS(a, s) };
+	DEC_BUF_FIELDS(Foo)
+*/
+#define BUF_FIELDS(...)	ByteBuffer &buf_pack(ByteBuffer &b) const{	return buf_pack_fields(b,__VA_ARGS__);}	ByteBuffer &buf_unpack(ByteBuffer &b){	return buf_unpack_fields(b,__VA_ARGS__);}
+#define DEC_BUF_FIELDS(type)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return t.buf_pack(b);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return t.buf_unpack(b);} 
+
 //л
 #define DEC_BUF_MEMCPY(type)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){b.append(t);	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	b.get((unsigned char *)&t,sizeof(t));	return b;} 
-#define DEC_BUF_OP1(type,p1)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1;	return b;} 
-#define DEC_BUF_OP2(type,p1,p2)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2;	return b;} 
-#define DEC_BUF_OP3(type,p1,p2,p3)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3;	return b;} 
-#define DEC_BUF_OP4(type,p1,p2,p3,p4)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4;	return b;} 
-#define DEC_BUF_OP5(type,p1,p2,p3,p4,p5)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5;	return b;} 
-#define DEC_BUF_OP6(type,p1,p2,p3,p4,p5,p6)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6;	return b;} 
-#define DEC_BUF_OP7(type,p1,p2,p3,p4,p5,p6,p7)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7;	return b;} 
-#define DEC_BUF_OP8(type,p1,p2,p3,p4,p5,p6,p7,p8)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8;	return b;} 
-#define DEC_BUF_OP9(type,p1,p2,p3,p4,p5,p6,p7,p8,p9)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9;	return b;} 
-#define DEC_BUF_OP10(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10;	return b;} 
-#define DEC_BUF_OP11(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11;	return b;} 
-#define DEC_BUF_OP12(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12;	return b;} 
-#define DEC_BUF_OP13(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13;	return b;} 
-#define DEC_BUF_OP14(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14;	return b;} 
-#define DEC_BUF_OP15(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15;	return b;} 
-#define DEC_BUF_OP16(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16;	return b;} 
-#define DEC_BUF_OP17(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17;	return b;} 
-#define DEC_BUF_OP18(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18;	return b;} 
-#define DEC_BUF_OP19(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19;	return b;} 
-#define DEC_BUF_OP20(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20;	return b;} 
-#define DEC_BUF_OP21(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21;	return b;} 
-#define DEC_BUF_OP22(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22;	return b;} 
-#define DEC_BUF_OP23(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23;	return b;} 
-#define DEC_BUF_OP24(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24;	return b;} 
-#define DEC_BUF_OP25(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25;	return b;} 
-#define DEC_BUF_OP26(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26;	return b;} 
-#define DEC_BUF_OP27(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26<<t.p27;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26>>t.p27;	return b;} 
-#define DEC_BUF_OP28(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26<<t.p27<<t.p28;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26>>t.p27>>t.p28;	return b;} 
-#define DEC_BUF_OP29(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26<<t.p27<<t.p28<<t.p29;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26>>t.p27>>t.p28>>t.p29;	return b;} 
-#define DEC_BUF_OP30(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26<<t.p27<<t.p28<<t.p29<<t.p30;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26>>t.p27>>t.p28>>t.p29>>t.p30;	return b;} 
-#define DEC_BUF_OP31(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26<<t.p27<<t.p28<<t.p29<<t.p30<<t.p31;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26>>t.p27>>t.p28>>t.p29>>t.p30>>t.p31;	return b;} 
-#define DEC_BUF_OP32(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31,p32)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26<<t.p27<<t.p28<<t.p29<<t.p30<<t.p31<<t.p32;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26>>t.p27>>t.p28>>t.p29>>t.p30>>t.p31>>t.p32;	return b;} 
-#define DEC_BUF_OP33(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31,p32,p33)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26<<t.p27<<t.p28<<t.p29<<t.p30<<t.p31<<t.p32<<t.p33;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26>>t.p27>>t.p28>>t.p29>>t.p30>>t.p31>>t.p32>>t.p33;	return b;} 
-#define DEC_BUF_OP34(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31,p32,p33,p34)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26<<t.p27<<t.p28<<t.p29<<t.p30<<t.p31<<t.p32<<t.p33<<t.p34;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26>>t.p27>>t.p28>>t.p29>>t.p30>>t.p31>>t.p32>>t.p33>>t.p34;	return b;} 
-#define DEC_BUF_OP35(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31,p32,p33,p34,p35)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26<<t.p27<<t.p28<<t.p29<<t.p30<<t.p31<<t.p32<<t.p33<<t.p34<<t.p35;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26>>t.p27>>t.p28>>t.p29>>t.p30>>t.p31>>t.p32>>t.p33>>t.p34>>t.p35;	return b;} 
-#define DEC_BUF_OP36(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31,p32,p33,p34,p35,p36)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){		b<<t.p1<<t.p2<<t.p3<<t.p4<<t.p5<<t.p6<<t.p7<<t.p8<<t.p9<<t.p10<<t.p11<<t.p12<<t.p13<<t.p14<<t.p15<<t.p16<<t.p17<<t.p18<<t.p19<<t.p20<<t.p21<<t.p22<<t.p23<<t.p24<<t.p25<<t.p26<<t.p27<<t.p28<<t.p29<<t.p30<<t.p31<<t.p32<<t.p33<<t.p34<<t.p35<<t.p36;	return b;} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){		b>>t.p1>>t.p2>>t.p3>>t.p4>>t.p5>>t.p6>>t.p7>>t.p8>>t.p9>>t.p10>>t.p11>>t.p12>>t.p13>>t.p14>>t.p15>>t.p16>>t.p17>>t.p18>>t.p19>>t.p20>>t.p21>>t.p22>>t.p23>>t.p24>>t.p25>>t.p26>>t.p27>>t.p28>>t.p29>>t.p30>>t.p31>>t.p32>>t.p33>>t.p34>>t.p35>>t.p36;	return b;} 
+#define DEC_BUF_OP1(type,p1)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1);} 
+#define DEC_BUF_OP2(type,p1,p2)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2);} 
+#define DEC_BUF_OP3(type,p1,p2,p3)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3);} 
+#define DEC_BUF_OP4(type,p1,p2,p3,p4)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4);} 
+#define DEC_BUF_OP5(type,p1,p2,p3,p4,p5)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5);} 
+#define DEC_BUF_OP6(type,p1,p2,p3,p4,p5,p6)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6);} 
+#define DEC_BUF_OP7(type,p1,p2,p3,p4,p5,p6,p7)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7);} 
+#define DEC_BUF_OP8(type,p1,p2,p3,p4,p5,p6,p7,p8)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8);} 
+#define DEC_BUF_OP9(type,p1,p2,p3,p4,p5,p6,p7,p8,p9)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9);} 
+#define DEC_BUF_OP10(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10);} 
+#define DEC_BUF_OP11(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11);} 
+#define DEC_BUF_OP12(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12);} 
+#define DEC_BUF_OP13(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13);} 
+#define DEC_BUF_OP14(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14);} 
+#define DEC_BUF_OP15(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15);} 
+#define DEC_BUF_OP16(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16);} 
+#define DEC_BUF_OP17(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17);} 
+#define DEC_BUF_OP18(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18);} 
+#define DEC_BUF_OP19(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19);} 
+#define DEC_BUF_OP20(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20);} 
+#define DEC_BUF_OP21(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21);} 
+#define DEC_BUF_OP22(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22);} 
+#define DEC_BUF_OP23(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23);} 
+#define DEC_BUF_OP24(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24);} 
+#define DEC_BUF_OP25(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25);} 
+#define DEC_BUF_OP26(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26);} 
+#define DEC_BUF_OP27(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27);} 
+#define DEC_BUF_OP28(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28);} 
+#define DEC_BUF_OP29(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29);} 
+#define DEC_BUF_OP30(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30);} 
+#define DEC_BUF_OP31(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31);} 
+#define DEC_BUF_OP32(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31,p32)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31,t.p32);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31,t.p32);} 
+#define DEC_BUF_OP33(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31,p32,p33)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31,t.p32,t.p33);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31,t.p32,t.p33);} 
+#define DEC_BUF_OP34(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31,p32,p33,p34)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31,t.p32,t.p33,t.p34);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31,t.p32,t.p33,t.p34);} 
+#define DEC_BUF_OP35(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31,p32,p33,p34,p35)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31,t.p32,t.p33,t.p34,t.p35);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31,t.p32,t.p33,t.p34,t.p35);} 
+#define DEC_BUF_OP36(type,p1,p2,p3,p4,p5,p6,p7,p8,p9,p10,p11,p12,p13,p14,p15,p16,p17,p18,p19,p20,p21,p22,p23,p24,p25,p26,p27,p28,p29,p30,p31,p32,p33,p34,p35,p36)	inline ByteBuffer &operator<<(ByteBuffer &b,const type & t){	return buf_pack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31,t.p32,t.p33,t.p34,t.p35,t.p36);} inline ByteBuffer &operator>>(ByteBuffer &b, type & t){	return buf_unpack_fields(b,t.p1,t.p2,t.p3,t.p4,t.p5,t.p6,t.p7,t.p8,t.p9,t.p10,t.p11,t.p12,t.p13,t.p14,t.p15,t.p16,t.p17,t.p18,t.p19,t.p20,t.p21,t.p22,t.p23,t.p24,t.p25,t.p26,t.p27,t.p28,t.p29,t.p30,t.p31,t.p32,t.p33,t.p34,t.p35,t.p36);} 
 
 #endif
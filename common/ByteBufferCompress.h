@@ -0,0 +1,291 @@
+#pragma once
+
+#ifndef _BYTEBUFFER_COMPRESS_H
+#define _BYTEBUFFER_COMPRESS_H
+
+#include <cstring>
+#include "ByteBuffer.h"
+
+/*
+ѡѹ룬Ҫڰͷļǰ岢ӶӦĿ⣺
+	BYTEBUFFER_WITH_LZ4		lz4(lz4.h/lz4hc.h)ѹѹܿ죬Ϣ
+	BYTEBUFFER_WITH_ZSTD	zstd(zstd.h)ѹʸߣڴ
+ʱֻʹBUF_CODEC_NONE
+*/
+#ifdef BYTEBUFFER_WITH_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#ifdef BYTEBUFFER_WITH_ZSTD
+#include <zstd.h>
+#include <boost/thread/tss.hpp>
+#include <boost/thread/once.hpp>
+#endif
+
+enum buf_codec
+{
+	BUF_CODEC_NONE = 0,		//ѹ
+	BUF_CODEC_LZ4 = 1,
+	BUF_CODEC_ZSTD = 2,
+};
+
+//֡ͷcodec(1ֽ) ԭʼ(4ֽ) ѹ󳤶(4ֽ)ΪС
+#define BUF_FRAME_HEADER		9
+
+//ССĬϲѹ
+#define BUF_COMPRESS_MIN_SIZE	256
+
+//ѹʱԭʼȣֹ֡ͷ´
+#ifndef BUF_FRAME_MAX_RAW
+#define BUF_FRAME_MAX_RAW		(256 * 1024 * 1024)
+#endif
+
+struct buf_frame_header
+{
+	int		codec;
+	size_t	raw_size;
+	size_t	compressed_size;
+};
+
+inline void buf_put_le32(unsigned char *p, size_t v){
+	p[0] = (unsigned char)v;
+	p[1] = (unsigned char)(v >> 8);
+	p[2] = (unsigned char)(v >> 16);
+	p[3] = (unsigned char)(v >> 24);
+}
+
+inline size_t buf_get_le32(const unsigned char *p){
+	return (size_t)p[0] | ((size_t)p[1] << 8) | ((size_t)p[2] << 16) | ((size_t)p[3] << 24);
+}
+
+inline bool buf_codec_supported(int codec){
+	switch (codec){
+	case BUF_CODEC_NONE:	return true;
+#ifdef BYTEBUFFER_WITH_LZ4
+	case BUF_CODEC_LZ4:		return true;
+#endif
+#ifdef BYTEBUFFER_WITH_ZSTD
+	case BUF_CODEC_ZSTD:	return true;
+#endif
+	default:				return false;
+	}
+}
+
+#ifdef BYTEBUFFER_WITH_ZSTD
+inline void buf_zstd_free_cctx(ZSTD_CCtx *c){ ZSTD_freeCCtx(c); }
+inline void buf_zstd_free_dctx(ZSTD_DCtx *c){ ZSTD_freeDCtx(c); }
+
+//ѹ/ѹĵTSSۣһݣӲ
+struct buf_zstd_tss
+{
+	boost::thread_specific_ptr<ZSTD_CCtx>	cctx;
+	boost::thread_specific_ptr<ZSTD_DCtx>	dctx;
+
+	buf_zstd_tss() : cctx(buf_zstd_free_cctx), dctx(buf_zstd_free_dctx){}
+};
+
+inline buf_zstd_tss *&buf_zstd_tss_slot(){
+	static buf_zstd_tss *s_tss = 0;
+	return s_tss;
+}
+
+inline void buf_zstd_create_tss(){
+	buf_zstd_tss_slot() = new buf_zstd_tss();
+}
+
+//VS2013ĺھ̬ʼ̰߳ȫģcall_once
+inline buf_zstd_tss &buf_zstd_get_tss(){
+	static boost::once_flag s_once = BOOST_ONCE_INIT;
+	boost::call_once(s_once, buf_zstd_create_tss);
+	return *buf_zstd_tss_slot();
+}
+
+//ÿ̸߳һѹ/ѹģÿη
+inline ZSTD_CCtx *buf_zstd_cctx(){
+	boost::thread_specific_ptr<ZSTD_CCtx> &ctx = buf_zstd_get_tss().cctx;
+	if (!ctx.get())
+		ctx.reset(ZSTD_createCCtx());
+	return ctx.get();
+}
+
+inline ZSTD_DCtx *buf_zstd_dctx(){
+	boost::thread_specific_ptr<ZSTD_DCtx> &ctx = buf_zstd_get_tss().dctx;
+	if (!ctx.get())
+		ctx.reset(ZSTD_createDCtx());
+	return ctx.get();
+}
+#endif
+
+//ѹ󳤶ȣcodec֧ʱ0
+inline size_t buf_compress_bound(int codec, size_t size){
+	switch (codec){
+	case BUF_CODEC_NONE:	return size;
+#ifdef BYTEBUFFER_WITH_LZ4
+	case BUF_CODEC_LZ4:		return size > LZ4_MAX_INPUT_SIZE ? 0 : (size_t)LZ4_compressBound((int)size);
+#endif
+#ifdef BYTEBUFFER_WITH_ZSTD
+	case BUF_CODEC_ZSTD:	return ZSTD_compressBound(size);
+#endif
+	default:				return 0;
+	}
+}
+
+/*
+ѹdstѹĳȣʧܻѹ󲻱ԭСʱ0
+level: lz4<=0Ϊģʽ(ٱΪ-level)>0ʹHCzstd0ΪĬϼ
+*/
+inline size_t buf_compress_raw(int codec, int level, const void *src, size_t size, void *dst, size_t capacity){
+	size_t n = 0;
+	switch (codec){
+#ifdef BYTEBUFFER_WITH_LZ4
+	case BUF_CODEC_LZ4:{
+		int cap = capacity > LZ4_MAX_INPUT_SIZE ? LZ4_MAX_INPUT_SIZE : (int)capacity;
+		int r;
+		if (level > 0)
+			r = LZ4_compress_HC((const char *)src, (char *)dst, (int)size, cap, level);
+		else
+			r = LZ4_compress_fast((const char *)src, (char *)dst, (int)size, cap, level < 0 ? -level : 1);
+		n = r > 0 ? (size_t)r : 0;
+		break;
+	}
+#endif
+#ifdef BYTEBUFFER_WITH_ZSTD
+	case BUF_CODEC_ZSTD:{
+		size_t r = ZSTD_compressCCtx(buf_zstd_cctx(), dst, capacity, src, size, level);
+		n = ZSTD_isError(r) ? 0 : r;
+		break;
+	}
+#endif
+	default:
+		break;
+	}
+	return n < size ? n : 0;
+}
+
+//ѹdstdstraw_sizeֽڣɹʱtrue
+inline bool buf_decompress_raw(int codec, const void *src, size_t size, void *dst, size_t raw_size){
+	switch (codec){
+	case BUF_CODEC_NONE:
+		if (size != raw_size)
+			return false;
+		memcpy(dst, src, size);
+		return true;
+#ifdef BYTEBUFFER_WITH_LZ4
+	case BUF_CODEC_LZ4:
+		return LZ4_decompress_safe((const char *)src, (char *)dst, (int)size, (int)raw_size) == (int)raw_size;
+#endif
+#ifdef BYTEBUFFER_WITH_ZSTD
+	case BUF_CODEC_ZSTD:
+		return ZSTD_decompressDCtx(buf_zstd_dctx(), dst, raw_size, src, size) == raw_size;
+#endif
+	default:
+		return false;
+	}
+}
+
+/*
+sizeֽѹһ֡׷ӵdst֡ĴС
+Сmin_sizeѹûбСʱBUF_CODEC_NONE棻codecûбʱByteBufferException
+*/
+inline size_t buf_compress_frame(ByteBuffer &dst, const void *src, size_t size, int codec,
+	int level = 0, size_t min_size = BUF_COMPRESS_MIN_SIZE){
+	if (!buf_codec_supported(codec))
+		throw ByteBufferException("codec unsupported", 0, dst.wpos(), codec, size);
+	if (size > 0xffffffffu)
+		throw ByteBufferException("frame too large", 0, dst.wpos(), size, size);
+
+	size_t start = dst.wpos();
+	size_t n = 0;
+	if (codec != BUF_CODEC_NONE && size >= min_size){
+		//ֱѹdstУĿռ˻
+		size_t bound = buf_compress_bound(codec, size);
+		if (bound){
+			unsigned char *p = dst.append_space(BUF_FRAME_HEADER + bound);
+			n = buf_compress_raw(codec, level, src, size, p + BUF_FRAME_HEADER, bound);
+			dst.wpos(start);
+		}
+	}
+	if (!n)
+		codec = BUF_CODEC_NONE;
+
+	unsigned char *h = dst.append_space(BUF_FRAME_HEADER);
+	h[0] = (unsigned char)codec;
+	buf_put_le32(h + 1, size);
+	buf_put_le32(h + 5, n ? n : size);
+	if (n)
+		dst.wpos(start + BUF_FRAME_HEADER + n);
+	else
+		dst.append(src, size);
+	return dst.wpos() - start;
+}
+
+inline ByteBuffer buf_compress(const ByteBuffer &src, int codec, int level = 0, size_t min_size = BUF_COMPRESS_MIN_SIZE){
+	ByteBuffer dst;
+	buf_compress_frame(dst, src.contents(), src.size(), codec, level, min_size);
+	return dst;
+}
+
+//֡ͷݲ֡ͷЧʱfalse
+inline bool buf_peek_frame(const void *data, size_t size, buf_frame_header &h, size_t max_raw = BUF_FRAME_MAX_RAW){
+	const unsigned char *p = (const unsigned char *)data;
+	if (size < BUF_FRAME_HEADER)
+		return false;
+	h.codec = p[0];
+	h.raw_size = buf_get_le32(p + 1);
+	h.compressed_size = buf_get_le32(p + 5);
+	if (h.raw_size > max_raw)
+		return false;
+	return h.codec != BUF_CODEC_NONE || h.raw_size == h.compressed_size;
+}
+
+/*
+ѹsrcrposһ֡dstβdstԭʼһη䣬ѹֱд롣
+֡Чcodec֧ʱByteBufferExceptionsrcrpos
+*/
+inline void buf_decompress_frame(ByteBuffer &src, ByteBuffer &dst, size_t max_raw = BUF_FRAME_MAX_RAW){
+	buf_frame_header h;
+	const unsigned char *p = src.contents() + src.rpos();
+	size_t avail = src.size() - src.rpos();
+	if (!buf_peek_frame(p, avail, h, max_raw) || h.compressed_size > avail - BUF_FRAME_HEADER)
+		throw ByteBufferException("bad frame", src.rpos(), src.wpos(), BUF_FRAME_HEADER, src.size());
+	if (!buf_codec_supported(h.codec))
+		throw ByteBufferException("codec unsupported", src.rpos(), src.wpos(), h.codec, src.size());
+
+	size_t start = dst.wpos();
+	unsigned char *out = dst.append_space(h.raw_size);
+	if (!buf_decompress_raw(h.codec, p + BUF_FRAME_HEADER, h.compressed_size, out, h.raw_size)){
+		dst.wpos(start);
+		throw ByteBufferException("decompress", src.rpos(), src.wpos(), h.compressed_size, src.size());
+	}
+	src.rpos(src.rpos() + BUF_FRAME_HEADER + h.compressed_size);
+}
+
+/*
+ѹһ֡ûѹ֡srcԼĴ洢ʱֱsrcڴ棬
+*/
+inline ByteBuffer buf_decompress(ByteBuffer &src, size_t max_raw = BUF_FRAME_MAX_RAW){
+	buf_frame_header h;
+	const unsigned char *p = src.contents() + src.rpos();
+	size_t avail = src.size() - src.rpos();
+	if (buf_peek_frame(p, avail, h, max_raw) && h.codec == BUF_CODEC_NONE
+		&& h.raw_size <= avail - BUF_FRAME_HEADER && src.storage()){
+		ByteBuffer b(boost::shared_ptr<unsigned char>(src.storage(), const_cast<unsigned char *>(p) + BUF_FRAME_HEADER), h.raw_size);
+		b.array_with_bytes_ = src.array_with_bytes_;
+		b.varint_ = src.varint_;
+		b.byte_order_ = src.byte_order_;
+		src.rpos(src.rpos() + BUF_FRAME_HEADER + h.raw_size);
+		return b;
+	}
+
+	ByteBuffer dst;
+	dst.array_with_bytes_ = src.array_with_bytes_;
+	dst.varint_ = src.varint_;
+	dst.byte_order_ = src.byte_order_;
+	if (avail >= BUF_FRAME_HEADER)
+		dst.reserve(buf_get_le32(p + 1) <= max_raw ? buf_get_le32(p + 1) : 0);
+	buf_decompress_frame(src, dst, max_raw);
+	return dst;
+}
+
+#endif
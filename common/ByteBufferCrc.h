@@ -0,0 +1,247 @@
+#pragma once
+
+#ifndef _BYTEBUFFER_CRC_H
+#define _BYTEBUFFER_CRC_H
+
+#include <cstring>
+#include <boost/thread/once.hpp>
+#include "ByteBuffer.h"
+#include "ByteOrder.h"
+
+#ifdef BUF_X86
+#include <nmmintrin.h>
+#endif
+
+/*
+CRC32C(Castagnoli)У飬ڼ̺ʹǷ𻵡
+	- SSE4.2ʱcrc32ָݷֳͬʱٺϲڸָ3ӳ
+	- slicing-by-8ÿδ8ֽ
+*/
+#define BUF_CRC32C_POLY		0x82f63b78u
+
+//βʱÿεĳȣֱڳݺʣµĲ
+#define BUF_CRC32C_LONG		8192
+#define BUF_CRC32C_SHORT	256
+
+struct buf_crc32c_tables
+{
+	unsigned int	slice[8][256];		//slicing-by-8
+	unsigned int	zeros_long[4][256];	//crcBUF_CRC32C_LONG0ֽ
+	unsigned int	zeros_short[4][256];
+};
+
+//GF(2)32x32
+inline unsigned int buf_gf2_times(const unsigned int *mat, unsigned int vec){
+	unsigned int sum = 0;
+	while (vec){
+		if (vec & 1)
+			sum ^= *mat;
+		vec >>= 1;
+		mat++;
+	}
+	return sum;
+}
+
+inline void buf_gf2_square(unsigned int *square, const unsigned int *mat){
+	for (int n = 0; n < 32; n++)
+		square[n] = buf_gf2_times(mat, mat[n]);
+}
+
+//crc׷len(2)0ֽڵĲұϲεĽʱʹ
+inline void buf_crc32c_zeros(unsigned int zeros[4][256], size_t len){
+	unsigned int odd[32], even[32];
+	odd[0] = BUF_CRC32C_POLY;
+	for (int n = 1; n < 32; n++)
+		odd[n] = 1u << (n - 1);
+	buf_gf2_square(even, odd);		//20λ
+	buf_gf2_square(odd, even);		//40λ
+
+	//ÿƽȷһεõ10ֽ
+	const unsigned int *op = odd;
+	do{
+		if (op == odd){
+			buf_gf2_square(even, odd);
+			op = even;
+		}else{
+			buf_gf2_square(odd, even);
+			op = odd;
+		}
+		len >>= 1;
+	}while (len);
+	for (unsigned int n = 0; n < 256; n++){
+		zeros[0][n] = buf_gf2_times(op, n);
+		zeros[1][n] = buf_gf2_times(op, n << 8);
+		zeros[2][n] = buf_gf2_times(op, n << 16);
+		zeros[3][n] = buf_gf2_times(op, n << 24);
+	}
+}
+
+inline void buf_crc32c_init_tables(buf_crc32c_tables *t){
+	for (unsigned int n = 0; n < 256; n++){
+		unsigned int crc = n;
+		for (int k = 0; k < 8; k++)
+			crc = crc & 1 ? (crc >> 1) ^ BUF_CRC32C_POLY : crc >> 1;
+		t->slice[0][n] = crc;
+	}
+	for (unsigned int n = 0; n < 256; n++){
+		unsigned int crc = t->slice[0][n];
+		for (int k = 1; k < 8; k++){
+			crc = t->slice[0][crc & 0xff] ^ (crc >> 8);
+			t->slice[k][n] = crc;
+		}
+	}
+	buf_crc32c_zeros(t->zeros_long, BUF_CRC32C_LONG);
+	buf_crc32c_zeros(t->zeros_short, BUF_CRC32C_SHORT);
+}
+
+//ûй캯Ҫ̬ʼ
+inline buf_crc32c_tables &buf_crc32c_tables_storage(){
+	static buf_crc32c_tables s_tables;
+	return s_tables;
+}
+
+inline void buf_crc32c_init_once(){
+	buf_crc32c_init_tables(&buf_crc32c_tables_storage());
+}
+
+//ұֻһΣ̵߳һεʱҲǰȫ
+inline const buf_crc32c_tables &buf_crc32c_get_tables(){
+	static boost::once_flag s_once = BOOST_ONCE_INIT;
+	boost::call_once(s_once, buf_crc32c_init_once);
+	return buf_crc32c_tables_storage();
+}
+
+inline unsigned int buf_load_le32(const unsigned char *p){
+	return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+//ʵ֣crcΪ֮ǰĽ(ʼʱΪ0)
+inline unsigned int buf_crc32c_sw(unsigned int crc, const void *data, size_t len){
+	const buf_crc32c_tables &t = buf_crc32c_get_tables();
+	const unsigned char *p = (const unsigned char *)data;
+	crc = ~crc;
+	for (; len >= 8; len -= 8, p += 8){
+		unsigned int a = buf_load_le32(p) ^ crc;
+		unsigned int b = buf_load_le32(p + 4);
+		crc = t.slice[7][a & 0xff] ^ t.slice[6][(a >> 8) & 0xff] ^ t.slice[5][(a >> 16) & 0xff] ^ t.slice[4][a >> 24]
+			^ t.slice[3][b & 0xff] ^ t.slice[2][(b >> 8) & 0xff] ^ t.slice[1][(b >> 16) & 0xff] ^ t.slice[0][b >> 24];
+	}
+	while (len--)
+		crc = t.slice[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+	return ~crc;
+}
+
+inline unsigned int buf_crc32c_shift(const unsigned int zeros[4][256], unsigned int crc){
+	return zeros[0][crc & 0xff] ^ zeros[1][(crc >> 8) & 0xff] ^ zeros[2][(crc >> 16) & 0xff] ^ zeros[3][crc >> 24];
+}
+
+#ifdef BUF_X86
+#if defined(_M_X64) || defined(__x86_64__)
+typedef unsigned long long	buf_crc_word;
+#define BUF_CRC_STEP(c, p)	(unsigned int)_mm_crc32_u64(c, buf_crc_load64(p))
+inline unsigned long long buf_crc_load64(const unsigned char *p){
+	unsigned long long v;
+	memcpy(&v, p, 8);
+	return v;
+}
+#else
+//32λÿ4ֽ
+typedef unsigned int		buf_crc_word;
+#define BUF_CRC_STEP(c, p)	_mm_crc32_u32(c, buf_load_le32(p))
+#endif
+
+//βдlenֽn*3Ĳ
+BUF_TARGET("sse4.2")
+inline unsigned int buf_crc32c_lanes(unsigned int crc, const unsigned char *&p, size_t &len,
+	size_t lane, const unsigned int zeros[4][256]){
+	while (len >= lane * 3){
+		buf_crc_word c0 = crc, c1 = 0, c2 = 0;
+		const unsigned char *end = p + lane;
+		for (; p < end; p += sizeof(buf_crc_word)){
+			c0 = BUF_CRC_STEP(c0, p);
+			c1 = BUF_CRC_STEP(c1, p + lane);
+			c2 = BUF_CRC_STEP(c2, p + lane * 2);
+		}
+		crc = buf_crc32c_shift(zeros, (unsigned int)c0) ^ (unsigned int)c1;
+		crc = buf_crc32c_shift(zeros, crc) ^ (unsigned int)c2;
+		p += lane * 2;
+		len -= lane * 3;
+	}
+	return crc;
+}
+
+BUF_TARGET("sse4.2")
+inline unsigned int buf_crc32c_hw(unsigned int crc, const void *data, size_t len){
+	const buf_crc32c_tables &t = buf_crc32c_get_tables();
+	const unsigned char *p = (const unsigned char *)data;
+	crc = ~crc;
+	while (len && ((size_t)p & (sizeof(buf_crc_word) - 1))){
+		crc = _mm_crc32_u8(crc, *p++);
+		len--;
+	}
+	crc = buf_crc32c_lanes(crc, p, len, BUF_CRC32C_LONG, t.zeros_long);
+	crc = buf_crc32c_lanes(crc, p, len, BUF_CRC32C_SHORT, t.zeros_short);
+	buf_crc_word c = crc;
+	for (; len >= sizeof(buf_crc_word); len -= sizeof(buf_crc_word), p += sizeof(buf_crc_word))
+		c = BUF_CRC_STEP(c, p);
+	crc = (unsigned int)c;
+	while (len--)
+		crc = _mm_crc32_u8(crc, *p++);
+	return ~crc;
+}
+#endif
+
+//CRC32CcrcΪ֮ǰֵĽԷֶμ
+inline unsigned int buf_crc32c(const void *data, size_t len, unsigned int crc = 0){
+#ifdef BUF_X86
+	if (buf_cpu_has_sse42())
+		return buf_crc32c_hw(crc, data, len);
+#endif
+	return buf_crc32c_sw(crc, data, len);
+}
+
+inline unsigned int buf_crc32c(const ByteBuffer &b){
+	return buf_crc32c(b.contents(), b.size());
+}
+
+/*
+Уβbĩβ׷bstart֮ݵCRC32C(4ֽС)
+һbuf_verify_crc32c
+*/
+inline void buf_append_crc32c(ByteBuffer &b, size_t start = 0){
+	if (start > b.size())
+		throw ByteBufferException("crc start", start, b.wpos(), 0, b.size());
+	unsigned int crc = buf_crc32c(b.contents() + start, b.size() - start);
+	unsigned char *p = b.append_space(4);
+	p[0] = (unsigned char)crc;
+	p[1] = (unsigned char)(crc >> 8);
+	p[2] = (unsigned char)(crc >> 16);
+	p[3] = (unsigned char)(crc >> 24);
+}
+
+/*
+brpos֮ݺĩβУβزУβݣbĩβ
+ֵbĴ洢(ⲿڴ洢ʱ)ʱByteBufferException
+*/
+inline ByteBuffer buf_verify_crc32c(ByteBuffer &b){
+	size_t avail = b.size() - b.rpos();
+	if (avail < 4)
+		throw ByteBufferException("crc missing", b.rpos(), b.wpos(), 4, b.size());
+	unsigned char *p = b.contents() + b.rpos();
+	size_t len = avail - 4;
+	if (buf_crc32c(p, len) != buf_load_le32(p + len))
+		throw ByteBufferException("crc mismatch", b.rpos(), b.wpos(), avail, b.size());
+
+	ByteBuffer r;
+	if (b.storage())
+		r = ByteBuffer(boost::shared_ptr<unsigned char>(b.storage(), p), len);
+	else
+		r.append(p, len);
+	r.array_with_bytes_ = b.array_with_bytes_;
+	r.varint_ = b.varint_;
+	r.byte_order_ = b.byte_order_;
+	b.rpos(b.size());
+	return r;
+}
+
+#endif
@@ -0,0 +1,338 @@
+#pragma once
+
+#ifndef _BYTEBUFFER_POOL_H
+#define _BYTEBUFFER_POOL_H
+
+#include <vector>
+#include <cstring>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/once.hpp>
+#include <boost/thread/tss.hpp>
+
+//ByteBuffer洢ռķͨByteBuffer::set_allocator滻
+struct ByteBufferAllocator
+{
+	//sizeֽڣsizeʵʿõĴС
+	virtual unsigned char *allocate(size_t &size) = 0;
+	//sizeΪallocateصĴС
+	virtual void deallocate(unsigned char *p, size_t size) = 0;
+
+	virtual ~ByteBufferAllocator(){}
+};
+
+//ֱʹnew[]/delete[]
+struct HeapByteBufferAllocator : public ByteBufferAllocator
+{
+	virtual unsigned char *allocate(size_t &size){
+		return new unsigned char[size];
+	}
+
+	virtual void deallocate(unsigned char *p, size_t size){
+		delete []p;
+	}
+};
+
+//shared_ptrɾڴ滹ķ
+struct ByteBufferDeleter
+{
+	ByteBufferAllocator	*allocator;
+	size_t				size;
+
+	ByteBufferDeleter(ByteBufferAllocator *a, size_t s) : allocator(a), size(s){}
+
+	void operator()(unsigned char *p) const{
+		allocator->deallocate(p, size);
+	}
+};
+
+//ڴͳ
+struct ByteBufferPoolStats
+{
+	enum { CLASS_COUNT = 11 };
+
+	struct Class{
+		size_t		block_size;			//С
+		long long	allocs;				//
+		long long	hits;				//ֱ̻߳ӷĴ
+		long long	cross_thread_frees;	//ڷǷ߳ͷŵĴ
+		long long	blocks_reserved;	//зֵĿ
+	};
+
+	Class		classes[CLASS_COUNT];
+	long long	bytes_in_use;			//ѷByteBufferֽ
+	long long	bytes_reserved;			//ϵͳֽ
+	long long	large_allocs;			//飬ֱnew[]Ĵ
+
+	double hit_rate(int cls) const{
+		return classes[cls].allocs ? (double)classes[cls].hits / classes[cls].allocs : 0.0;
+	}
+};
+
+/*
+Сּslabڴأÿ߳ԼĻ档
+	- 64B..64KB11ÿһȫֿ̻߳(BATCH)ȫȡ
+	- ͷŴ󲿷ʱֻʱ̻߳棬
+	- ߳ͷţͷ̵߳Ļ棬cross_thread_frees
+	- 64KBֱnew[]
+	- ͳ̻߳涨ڻܣȡʱͺ
+*/
+class SlabByteBufferAllocator : public ByteBufferAllocator
+{
+public:
+	enum {
+		CLASS_COUNT	= ByteBufferPoolStats::CLASS_COUNT,
+		MIN_BLOCK	= 64,
+		MAX_BLOCK	= MIN_BLOCK << (CLASS_COUNT - 1),
+		HEADER		= 16,				//ͷ16ֽڶ
+		BATCH		= 32,				//̻߳ȫ֮һƶĿ
+		SLAB_BYTES	= 256 * 1024,		//ÿϵͳĴС
+		STATS_FLUSH	= 256,				//̻߳ÿٴβһͳ
+	};
+
+	SlabByteBufferAllocator() : next_cache_id_(1){
+		for (int i = 0; i < CLASS_COUNT; i++){
+			free_[i] = 0;
+			allocs_[i] = 0;
+			hits_[i] = 0;
+			cross_frees_[i] = 0;
+			reserved_[i] = 0;
+		}
+		bytes_in_use_ = 0;
+		bytes_reserved_ = 0;
+		large_allocs_ = 0;
+	}
+
+	//ʱͷslab豣֤зֳĿ鶼Ѳʹ
+	~SlabByteBufferAllocator(){
+		caches_.reset();
+		for (size_t i = 0; i < slabs_.size(); i++)
+			delete []slabs_[i];
+	}
+
+	virtual unsigned char *allocate(size_t &size){
+		int cls = class_of(size);
+		if (cls < 0){
+			large_allocs_.fetch_add(1, boost::memory_order_relaxed);
+			bytes_in_use_.fetch_add((long long)size, boost::memory_order_relaxed);
+			return new unsigned char[size];
+		}
+
+		ThreadCache &cache = thread_cache();
+		ThreadCache::Class &c = cache.classes[cls];
+		if (c.count){
+			c.hits++;
+		}else{
+			refill(cls, c);
+		}
+		c.allocs++;
+
+		Block *b = c.blocks[--c.count];
+		b->owner = cache.id;
+
+		size = block_size(cls);
+		cache.bytes_in_use += (long long)size;
+		cache.tick();
+		return b->data();
+	}
+
+	virtual void deallocate(unsigned char *p, size_t size){
+		int cls = class_of(size);
+		if (cls < 0){
+			bytes_in_use_.fetch_sub((long long)size, boost::memory_order_relaxed);
+			delete []p;
+			return;
+		}
+
+		Block *b = Block::from_data(p);
+		ThreadCache &cache = thread_cache();
+		ThreadCache::Class &c = cache.classes[cls];
+		if (b->owner != cache.id)
+			c.cross_frees++;
+
+		if (c.count == 2 * BATCH)
+			release(cls, c, BATCH);
+		c.blocks[c.count++] = b;
+
+		cache.bytes_in_use -= (long long)block_size(cls);
+		cache.tick();
+	}
+
+	ByteBufferPoolStats stats() const{
+		ByteBufferPoolStats s;
+		for (int i = 0; i < CLASS_COUNT; i++){
+			s.classes[i].block_size = block_size(i);
+			s.classes[i].allocs = allocs_[i].load(boost::memory_order_relaxed);
+			s.classes[i].hits = hits_[i].load(boost::memory_order_relaxed);
+			s.classes[i].cross_thread_frees = cross_frees_[i].load(boost::memory_order_relaxed);
+			s.classes[i].blocks_reserved = reserved_[i].load(boost::memory_order_relaxed);
+		}
+		//̻߳ûʱܶΪ
+		s.bytes_in_use = bytes_in_use_.load(boost::memory_order_relaxed);
+		if (s.bytes_in_use < 0)
+			s.bytes_in_use = 0;
+		s.bytes_reserved = bytes_reserved_.load(boost::memory_order_relaxed);
+		s.large_allocs = large_allocs_.load(boost::memory_order_relaxed);
+		return s;
+	}
+
+	//ڹʵӲ(ʱܻByteBufferгеڴ)
+	//VS2013ĺھ̬ʼ̰߳ȫģcall_once
+	static SlabByteBufferAllocator &instance(){
+		static boost::once_flag s_once = BOOST_ONCE_INIT;
+		boost::call_once(s_once, create_instance);
+		return *instance_slot();
+	}
+
+	static size_t block_size(int cls){
+		return (size_t)MIN_BLOCK << cls;
+	}
+
+	//sizeļ𣬳鷵-1
+	static int class_of(size_t size){
+		if (size > MAX_BLOCK)
+			return -1;
+		int cls = 0;
+		while (block_size(cls) < size)
+			cls++;
+		return cls;
+	}
+
+private:
+	static SlabByteBufferAllocator *&instance_slot(){
+		static SlabByteBufferAllocator *s_pool = 0;
+		return s_pool;
+	}
+
+	static void create_instance(){
+		instance_slot() = new SlabByteBufferAllocator();
+	}
+
+	struct Block{
+		Block		*next;				//ȫֿʱʹ
+		unsigned int owner;				//̻߳
+
+		unsigned char *data(){
+			return (unsigned char *)this + HEADER;
+		}
+		static Block *from_data(unsigned char *p){
+			return (Block *)(p - HEADER);
+		}
+	};
+
+	struct ThreadCache{
+		struct Class{
+			Block		*blocks[2 * BATCH];
+			size_t		count;
+			long long	allocs, hits, cross_frees;
+		};
+
+		SlabByteBufferAllocator	*pool;
+		unsigned int			id;
+		unsigned int			ops;
+		long long				bytes_in_use;
+		Class					classes[CLASS_COUNT];
+
+		ThreadCache(SlabByteBufferAllocator *p, unsigned int i) : pool(p), id(i), ops(0), bytes_in_use(0){
+			memset(classes, 0, sizeof(classes));
+		}
+
+		//߳̽ʱѿ黹ȫ
+		~ThreadCache(){
+			for (int i = 0; i < CLASS_COUNT; i++){
+				if (classes[i].count)
+					pool->release(i, classes[i], classes[i].count);
+			}
+			flush_stats();
+		}
+
+		void tick(){
+			if (++ops >= STATS_FLUSH)
+				flush_stats();
+		}
+
+		void flush_stats(){
+			for (int i = 0; i < CLASS_COUNT; i++){
+				Class &c = classes[i];
+				pool->allocs_[i].fetch_add(c.allocs, boost::memory_order_relaxed);
+				pool->hits_[i].fetch_add(c.hits, boost::memory_order_relaxed);
+				pool->cross_frees_[i].fetch_add(c.cross_frees, boost::memory_order_relaxed);
+				c.allocs = c.hits = c.cross_frees = 0;
+			}
+			pool->bytes_in_use_.fetch_add(bytes_in_use, boost::memory_order_relaxed);
+			bytes_in_use = 0;
+			ops = 0;
+		}
+	};
+
+	ThreadCache &thread_cache(){
+		ThreadCache *cache = caches_.get();
+		if (!cache){
+			cache = new ThreadCache(this, next_cache_id_.fetch_add(1, boost::memory_order_relaxed));
+			caches_.reset(cache);
+		}
+		return *cache;
+	}
+
+	//ȫȡBATCH飬ʱзµslab
+	void refill(int cls, ThreadCache::Class &c){
+		boost::mutex::scoped_lock lock(locks_[cls]);
+		while (c.count < BATCH){
+			if (!free_[cls])
+				carve(cls);
+			Block *b = free_[cls];
+			free_[cls] = b->next;
+			c.blocks[c.count++] = b;
+		}
+	}
+
+	void release(int cls, ThreadCache::Class &c, size_t n){
+		boost::mutex::scoped_lock lock(locks_[cls]);
+		while (n--){
+			Block *b = c.blocks[--c.count];
+			b->next = free_[cls];
+			free_[cls] = b;
+		}
+	}
+
+	//߳locks_[cls]
+	void carve(int cls){
+		size_t stride = HEADER + block_size(cls);
+		size_t n = SLAB_BYTES / stride;
+		if (n < BATCH)
+			n = BATCH;
+
+		unsigned char *slab = new unsigned char[n * stride];
+		{
+			boost::mutex::scoped_lock lock(slabs_lock_);
+			slabs_.push_back(slab);
+		}
+		for (size_t i = 0; i < n; i++){
+			Block *b = (Block *)(slab + i * stride);
+			b->owner = 0;
+			b->next = free_[cls];
+			free_[cls] = b;
+		}
+		reserved_[cls].fetch_add((long long)n, boost::memory_order_relaxed);
+		bytes_reserved_.fetch_add((long long)(n * stride), boost::memory_order_relaxed);
+	}
+
+	boost::thread_specific_ptr<ThreadCache>	caches_;
+	boost::atomic<unsigned int>				next_cache_id_;
+
+	boost::mutex							locks_[CLASS_COUNT];
+	Block									*free_[CLASS_COUNT];
+
+	boost::mutex							slabs_lock_;
+	std::vector<unsigned char *>			slabs_;
+
+	boost::atomic<long long>				allocs_[CLASS_COUNT];
+	boost::atomic<long long>				hits_[CLASS_COUNT];
+	boost::atomic<long long>				cross_frees_[CLASS_COUNT];
+	boost::atomic<long long>				reserved_[CLASS_COUNT];
+	boost::atomic<long long>				bytes_in_use_;
+	boost::atomic<long long>				bytes_reserved_;
+	boost::atomic<long long>				large_allocs_;
+};
+
+#endif
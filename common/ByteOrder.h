@@ -0,0 +1,215 @@
+#pragma once
+
+#ifndef _BYTEORDER_H
+#define _BYTEORDER_H
+
+#include <cstring>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define BUF_X86 1
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
+//gccҪΪʹSSSE3/SSE4.2ָĺָĿ꣬msvcҪ
+#if defined(__GNUC__) && defined(BUF_X86)
+#define BUF_TARGET(t)	__attribute__((target(t)))
+#else
+#define BUF_TARGET(t)
+#endif
+
+//ByteBufferдֵֽʱֽ
+enum buf_byte_order
+{
+	BUF_HOST_ORDER = 0,		//ֽ򣬺ǰΪһ
+	BUF_LITTLE_ENDIAN = 1,
+	BUF_BIG_ENDIAN = 2,		//ֽ
+};
+
+//½ByteBufferĬֽ򣬿ڰͷļǰ
+#ifndef BYTEBUFFER_DEFAULT_BYTE_ORDER
+#define BYTEBUFFER_DEFAULT_BYTE_ORDER	BUF_HOST_ORDER
+#endif
+
+inline bool buf_host_is_big_endian(){
+	const unsigned short probe = 1;
+	return *(const unsigned char *)&probe == 0;
+}
+
+//orderǷҪֽ
+inline bool buf_order_needs_swap(int order){
+	if (order == BUF_HOST_ORDER)
+		return false;
+	return (order == BUF_BIG_ENDIAN) != buf_host_is_big_endian();
+}
+
+inline unsigned short buf_bswap16(unsigned short v){
+#ifdef _MSC_VER
+	return _byteswap_ushort(v);
+#else
+	return __builtin_bswap16(v);
+#endif
+}
+
+inline unsigned int buf_bswap32(unsigned int v){
+#ifdef _MSC_VER
+	return _byteswap_ulong(v);
+#else
+	return __builtin_bswap32(v);
+#endif
+}
+
+inline unsigned long long buf_bswap64(unsigned long long v){
+#ifdef _MSC_VER
+	return _byteswap_uint64(v);
+#else
+	return __builtin_bswap64(v);
+#endif
+}
+
+//һֵֽfloat/doubleͬС
+template<typename T>
+inline void buf_byte_swap(T &value){
+	switch (sizeof(T)){
+	case 2:{
+		unsigned short u;
+		memcpy(&u, &value, 2);
+		u = buf_bswap16(u);
+		memcpy(&value, &u, 2);
+		break;
+	}
+	case 4:{
+		unsigned int u;
+		memcpy(&u, &value, 4);
+		u = buf_bswap32(u);
+		memcpy(&value, &u, 4);
+		break;
+	}
+	case 8:{
+		unsigned long long u;
+		memcpy(&u, &value, 8);
+		u = buf_bswap64(u);
+		memcpy(&value, &u, 8);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+#ifdef BUF_X86
+//cpuid(1)ecxֻѯһ
+inline unsigned int buf_cpuid1_ecx(){
+	static int s_ecx = -1;
+	if (s_ecx == -1){
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 1);
+		s_ecx = info[2] & 0x7fffffff;
+#else
+		unsigned int a, b, c, d;
+		s_ecx = __get_cpuid(1, &a, &b, &c, &d) ? (int)(c & 0x7fffffff) : 0;
+#endif
+	}
+	return (unsigned int)s_ecx;
+}
+
+inline bool buf_cpu_has_ssse3(){
+	return (buf_cpuid1_ecx() & (1u << 9)) != 0;
+}
+
+inline bool buf_cpu_has_sse42(){
+	return (buf_cpuid1_ecx() & (1u << 20)) != 0;
+}
+
+//ÿδ32ֽڣѴֽ
+BUF_TARGET("ssse3")
+inline size_t buf_swap_ssse3(unsigned char *dst, const unsigned char *src, size_t bytes, size_t width){
+	__m128i mask;
+	if (width == 2)
+		mask = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+	else if (width == 4)
+		mask = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+	else
+		mask = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+	size_t i = 0;
+	for (; i + 32 <= bytes; i += 32){
+		__m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i b = _mm_loadu_si128((const __m128i *)(src + i + 16));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_shuffle_epi8(a, mask));
+		_mm_storeu_si128((__m128i *)(dst + i + 16), _mm_shuffle_epi8(b, mask));
+	}
+	if (i + 16 <= bytes){
+		__m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_shuffle_epi8(a, mask));
+		i += 16;
+	}
+	return i;
+}
+
+//ûSSSE3ʱ16λλʵ
+inline size_t buf_swap16_sse2(unsigned char *dst, const unsigned char *src, size_t bytes){
+	size_t i = 0;
+	for (; i + 16 <= bytes; i += 16){
+		__m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+		a = _mm_or_si128(_mm_slli_epi16(a, 8), _mm_srli_epi16(a, 8));
+		_mm_storeu_si128((__m128i *)(dst + i), a);
+	}
+	return i;
+}
+#endif
+
+/*
+countwidth(2/4/8)ֽԪصֽdstԵsrc
+x86SSSE3ʱpshufbÿָ16ֽ
+*/
+inline void buf_swap_array(void *dst, const void *src, size_t count, size_t width){
+	unsigned char *d = (unsigned char *)dst;
+	const unsigned char *s = (const unsigned char *)src;
+	size_t bytes = count * width;
+	size_t i = 0;
+
+	if (width != 2 && width != 4 && width != 8){
+		if (d != s)
+			memmove(d, s, bytes);
+		return;
+	}
+
+#ifdef BUF_X86
+	if (buf_cpu_has_ssse3())
+		i = buf_swap_ssse3(d, s, bytes, width);
+	else if (width == 2)
+		i = buf_swap16_sse2(d, s, bytes);
+#endif
+
+	for (; i < bytes; i += width){
+		if (width == 2){
+			unsigned short u;
+			memcpy(&u, s + i, 2);
+			u = buf_bswap16(u);
+			memcpy(d + i, &u, 2);
+		}else if (width == 4){
+			unsigned int u;
+			memcpy(&u, s + i, 4);
+			u = buf_bswap32(u);
+			memcpy(d + i, &u, 4);
+		}else{
+			unsigned long long u;
+			memcpy(&u, s + i, 8);
+			u = buf_bswap64(u);
+			memcpy(d + i, &u, 8);
+		}
+	}
+}
+
+#endif
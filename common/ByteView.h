@@ -0,0 +1,491 @@
+#pragma once
+
+#ifndef _BYTEVIEW_H
+#define _BYTEVIEW_H
+
+#include <string>
+#include <vector>
+#include <cstring>
+#include "ByteBuffer.h"
+
+/*
+ӵڴĶͼαͼԼϣͬһڴͬʱByteReader
+	- Խ粻쳣ʧܱ(iostreamfailbit)֮ĶȡʧܣֵΪ0
+	- һϢһok()
+	- ensure(n)ɹuread/uget߽Ķȡ
+	- 鳤ȿȡֽvarintģʽByteBufferĹһ£ByteBufferʱ
+*/
+class ByteReader
+{
+public:
+	ByteReader(const void *data, size_t size)
+		: begin_((const unsigned char *)data), p_(begin_), end_(begin_ + size),
+		  fail_(false), varint_(false), width_(BUF_VEC_WIDTH), byte_order_(BYTEBUFFER_DEFAULT_BYTE_ORDER){
+	}
+
+	//brpos֮ݣƶbα
+	explicit ByteReader(const ByteBuffer &b)
+		: begin_(b.contents() + b.rpos()), p_(begin_), end_(b.contents() + b.size()),
+		  fail_(false), varint_(b.varint_), width_(b.array_with_bytes_), byte_order_(b.byte_order_){
+	}
+
+	bool ok() const{ return !fail_; }
+	bool fail() const{ return fail_; }
+
+	size_t remaining() const{ return end_ - p_; }
+	size_t position() const{ return p_ - begin_; }
+	const unsigned char *current() const{ return p_; }
+
+	void set_width(unsigned int width){ width_ = width; }
+	void set_byte_order(int order){ byte_order_ = order; }
+	//ֽͳȰvarintȡͬByteBuffer::varint_mode
+	void set_varint(bool on){ varint_ = on; }
+
+	//֤nֽڣʧܱ
+	bool ensure(size_t n){
+		if (fail_)
+			return false;
+		if (n > (size_t)(end_ - p_)){
+			fail_ = true;
+			p_ = end_;
+			return false;
+		}
+		return true;
+	}
+
+	//߽磬ǰensure
+	template<typename T> T uread(){
+		T v;
+		memcpy(&v, p_, sizeof(T));
+		p_ += sizeof(T);
+		if (sizeof(T) > 1 && buf_order_needs_swap(byte_order_))
+			buf_byte_swap(v);
+		return v;
+	}
+
+	void uget(void *dest, size_t len){
+		memcpy(dest, p_, len);
+		p_ += len;
+	}
+
+	template<typename T> bool read(T &v){
+		if (!ensure(sizeof(T))){
+			v = T();
+			return false;
+		}
+		v = uread<T>();
+		return true;
+	}
+
+	template<typename T> T read(){
+		T v;
+		read(v);
+		return v;
+	}
+
+	//һvarintδ򳬹10ֽʱʧܱ
+	unsigned long long read_varint64(){
+		if (!fail_){
+			size_t avail = end_ - p_;
+			unsigned long long v = 0;
+			for (size_t i = 0; i < avail && i < 10; i++){
+				v |= (unsigned long long)(p_[i] & 0x7f) << (7 * i);
+				if (!(p_[i] & 0x80)){
+					p_ += i + 1;
+					return v;
+				}
+			}
+		}
+		set_fail();
+		return 0;
+	}
+
+	//зzigzagԭTĿʱʧܱ
+	template<typename T> bool read_varint(T &v){
+		unsigned long long u = read_varint64();
+		if (fail_ || (u >> (sizeof(T) * 8 - 1)) >> 1){
+			set_fail();
+			v = T();
+			return false;
+		}
+		if (std::numeric_limits<T>::is_signed)
+			v = (T)(long long)((u >> 1) ^ (0 - (u & 1)));
+		else
+			v = (T)u;
+		return true;
+	}
+
+	//ֽvarintģʽ°varintȡ
+	template<typename T> bool read_int(T &v){
+		return varint_ ? read_varint(v) : read(v);
+	}
+
+	bool get(void *dest, size_t len){
+		if (!ensure(len))
+			return false;
+		uget(dest, len);
+		return true;
+	}
+
+	bool skip(size_t len){
+		if (!ensure(len))
+			return false;
+		p_ += len;
+		return true;
+	}
+
+	//lenֽڵʼλãʧʱΪ0
+	const unsigned char *read_bytes(size_t len){
+		if (!ensure(len))
+			return 0;
+		const unsigned char *p = p_;
+		p_ += len;
+		return p;
+	}
+
+	size_t read_length(){
+		if (varint_){
+			unsigned long long n;
+			//Ȳᳬʣֽ
+			if (!read_varint(n) || n > (unsigned long long)(end_ - p_)){
+				set_fail();
+				return 0;
+			}
+			return (size_t)n;
+		}
+		if (!ensure(width_))
+			return 0;
+		bool big = byte_order_ == BUF_BIG_ENDIAN || (byte_order_ == BUF_HOST_ORDER && buf_host_is_big_endian());
+		unsigned long long n = 0;
+		for (unsigned int i = 0; i < width_; i++)
+			n |= (unsigned long long)p_[big ? width_ - 1 - i : i] << (8 * i);
+		p_ += width_;
+		return (size_t)n;
+	}
+
+	ByteReader &operator>>(char &v){ read(v); return *this; }
+	ByteReader &operator>>(unsigned char &v){ read(v); return *this; }
+	ByteReader &operator>>(short &v){ read_int(v); return *this; }
+	ByteReader &operator>>(unsigned short &v){ read_int(v); return *this; }
+	ByteReader &operator>>(int &v){ read_int(v); return *this; }
+	ByteReader &operator>>(unsigned int &v){ read_int(v); return *this; }
+	ByteReader &operator>>(long &v){ read_int(v); return *this; }
+	ByteReader &operator>>(unsigned long &v){ read_int(v); return *this; }
+	ByteReader &operator>>(long long &v){ read_int(v); return *this; }
+	ByteReader &operator>>(unsigned long long &v){ read_int(v); return *this; }
+	ByteReader &operator>>(float &v){ read(v); return *this; }
+	ByteReader &operator>>(double &v){ read(v); return *this; }
+
+	ByteReader &operator>>(bool &v){
+		v = read<char>() > 0;
+		return *this;
+	}
+
+	template<class _Type,class T2,class T3>
+	ByteReader &operator>>(std::basic_string<_Type,T2,T3> &s){
+		size_t len;
+		const _Type *p = read_string_ref<_Type>(len);
+		s.assign(p, len);
+		return *this;
+	}
+
+	//ָ򱻶ڴ棬Чͬڴ
+	template<class _Type,class T>
+	ByteReader &operator>>(boost::basic_string_ref<_Type,T> &s){
+		size_t len;
+		const _Type *p = read_string_ref<_Type>(len);
+		s = boost::basic_string_ref<_Type,T>(p, len);
+		return *this;
+	}
+
+#ifdef BYTEBUFFER_HAS_STRING_VIEW
+	template<class _Type,class T>
+	ByteReader &operator>>(std::basic_string_view<_Type,T> &s){
+		size_t len;
+		const _Type *p = read_string_ref<_Type>(len);
+		s = std::basic_string_view<_Type,T>(p, len);
+		return *this;
+	}
+#endif
+
+	//ʧʱؿմ
+	template<class _Type>
+	const _Type *read_string_ref(size_t &len){
+		static const _Type empty = _Type();
+		len = 0;
+		if (width_){
+			size_t n = read_length();
+			if (n > remaining() / sizeof(_Type)){
+				ensure(remaining() + 1);
+				return &empty;
+			}
+			len = n;
+			return (const _Type *)read_bytes(n * sizeof(_Type));
+		}
+		const _Type *p = (const _Type *)p_;
+		const _Type *z = fail_ ? 0 : std::char_traits<_Type>::find(p, remaining() / sizeof(_Type), _Type());
+		if (!z){
+			ensure(remaining() + 1);
+			return &empty;
+		}
+		len = z - p;
+		p_ = (const unsigned char *)(z + 1);
+		return p;
+	}
+
+	template<typename T>
+	ByteReader &operator>>(std::vector<T> &v){
+		read_vector(v, buf_blittable<T>());
+		return *this;
+	}
+
+private:
+	template<typename T>
+	void read_vector(std::vector<T> &v, boost::true_type){
+		size_t n = read_length();
+		bool varint = varint_ && buf_varint_type<T>::value;
+		//varintԪ1ֽڣÿԪsizeof(T)ֽ
+		if (n > remaining() / (varint ? 1 : sizeof(T))){
+			ensure(remaining() + 1);
+			v.clear();
+			return;
+		}
+		if (varint){
+			v.resize(n);
+			read_elements(n ? &v[0] : 0, n, buf_varint_type<T>());
+			return;
+		}
+		//ݲһT룬ֽڸ
+		v.resize(n);
+		if (!n)
+			return;
+		const unsigned char *p = read_bytes(n * sizeof(T));
+		if (sizeof(T) > 1 && buf_order_needs_swap(byte_order_))
+			buf_swap_array(&v[0], p, n, sizeof(T));
+		else
+			memcpy(&v[0], p, n * sizeof(T));
+	}
+
+	template<typename T>
+	void read_vector(std::vector<T> &v, boost::false_type){
+		size_t n = read_length();
+		v.clear();
+		//ÿԪ1ֽڣֹĳȵ´
+		if (n > remaining()){
+			ensure(remaining() + 1);
+			return;
+		}
+		v.resize(n);
+		for (size_t i = 0; i < n && ok(); i++)
+			*this >> v[i];
+	}
+
+	template<typename T>
+	void read_elements(T *v, size_t n, boost::true_type){
+		for (size_t i = 0; i < n && ok(); i++)
+			read_varint(v[i]);
+	}
+
+	template<typename T>
+	void read_elements(T *v, size_t n, boost::false_type){
+	}
+
+	void set_fail(){
+		fail_ = true;
+		p_ = end_;
+	}
+
+	const unsigned char	*begin_;
+	const unsigned char	*p_;
+	const unsigned char	*end_;
+	bool				fail_;
+	bool				varint_;
+	unsigned int		width_;
+	int					byte_order_;
+};
+
+/*
+ӵڴдͼдʱʧܱǶ쳣Ҳݡ
+дByteBuffer::append_space(n)صĿռС
+鳤ȿȡֽvarintģʽByteBufferĹһ¡
+*/
+class ByteWriter
+{
+public:
+	ByteWriter(void *data, size_t capacity)
+		: begin_((unsigned char *)data), p_(begin_), end_(begin_ + capacity),
+		  fail_(false), varint_(false), width_(BUF_VEC_WIDTH), byte_order_(BYTEBUFFER_DEFAULT_BYTE_ORDER){
+	}
+
+	bool ok() const{ return !fail_; }
+	bool fail() const{ return fail_; }
+
+	size_t size() const{ return p_ - begin_; }
+	size_t remaining() const{ return end_ - p_; }
+	unsigned char *data() const{ return begin_; }
+
+	void set_width(unsigned int width){ width_ = width; }
+	void set_byte_order(int order){ byte_order_ = order; }
+	//ֽͳȰvarintд룬ͬByteBuffer::varint_mode
+	void set_varint(bool on){ varint_ = on; }
+
+	bool ensure(size_t n){
+		if (fail_)
+			return false;
+		if (n > (size_t)(end_ - p_)){
+			fail_ = true;
+			return false;
+		}
+		return true;
+	}
+
+	//߽磬ǰensure
+	template<typename T> void uwrite(T v){
+		if (sizeof(T) > 1 && buf_order_needs_swap(byte_order_))
+			buf_byte_swap(v);
+		memcpy(p_, &v, sizeof(T));
+		p_ += sizeof(T);
+	}
+
+	void uput(const void *src, size_t len){
+		memcpy(p_, src, len);
+		p_ += len;
+	}
+
+	template<typename T> bool write(T v){
+		if (!ensure(sizeof(T)))
+			return false;
+		uwrite(v);
+		return true;
+	}
+
+	bool put(const void *src, size_t len){
+		if (!ensure(len))
+			return false;
+		uput(src, len);
+		return true;
+	}
+
+	//дλã糤ֶ
+	bool put_at(size_t pos, const void *src, size_t len){
+		if (fail_ || pos > size() || len > size() - pos){
+			fail_ = true;
+			return false;
+		}
+		memcpy(begin_ + pos, src, len);
+		return true;
+	}
+
+	//LEB128зzigzagռ䲻ʱʧܱ
+	template<typename T> bool write_varint(T v){
+		unsigned long long u = (unsigned long long)v;
+		if (std::numeric_limits<T>::is_signed)
+			u = ((unsigned long long)(long long)v << 1) ^ (unsigned long long)((long long)v >> 63);
+		unsigned char tmp[10];
+		size_t n = 0;
+		while (u >= 0x80){
+			tmp[n++] = (unsigned char)(u | 0x80);
+			u >>= 7;
+		}
+		tmp[n++] = (unsigned char)u;
+		return put(tmp, n);
+	}
+
+	//ֽvarintģʽ°varintд
+	template<typename T> bool write_int(T v){
+		return varint_ ? write_varint(v) : write(v);
+	}
+
+	bool write_length(size_t len){
+		if (varint_)
+			return write_varint((unsigned long long)len);
+		if (!ensure(width_))
+			return false;
+		bool big = byte_order_ == BUF_BIG_ENDIAN || (byte_order_ == BUF_HOST_ORDER && buf_host_is_big_endian());
+		for (unsigned int i = 0; i < width_; i++)
+			p_[big ? width_ - 1 - i : i] = (unsigned char)((unsigned long long)len >> (8 * i));
+		p_ += width_;
+		return true;
+	}
+
+	ByteWriter &operator<<(char v){ write(v); return *this; }
+	ByteWriter &operator<<(unsigned char v){ write(v); return *this; }
+	ByteWriter &operator<<(short v){ write_int(v); return *this; }
+	ByteWriter &operator<<(unsigned short v){ write_int(v); return *this; }
+	ByteWriter &operator<<(int v){ write_int(v); return *this; }
+	ByteWriter &operator<<(unsigned int v){ write_int(v); return *this; }
+	ByteWriter &operator<<(long v){ write_int(v); return *this; }
+	ByteWriter &operator<<(unsigned long v){ write_int(v); return *this; }
+	ByteWriter &operator<<(long long v){ write_int(v); return *this; }
+	ByteWriter &operator<<(unsigned long long v){ write_int(v); return *this; }
+	ByteWriter &operator<<(float v){ write(v); return *this; }
+	ByteWriter &operator<<(double v){ write(v); return *this; }
+
+	ByteWriter &operator<<(bool v){
+		write<unsigned char>(v);
+		return *this;
+	}
+
+	template<class _Type,class T2,class T3>
+	ByteWriter &operator<<(const std::basic_string<_Type,T2,T3> &s){
+		if (width_){
+			if (write_length(s.size()))
+				put(s.data(), s.size() * sizeof(_Type));
+		}else{
+			put(s.c_str(), (s.size() + 1) * sizeof(_Type));
+		}
+		return *this;
+	}
+
+	template<typename T>
+	ByteWriter &operator<<(const std::vector<T> &v){
+		write_vector(v, buf_blittable<T>());
+		return *this;
+	}
+
+private:
+	template<typename T>
+	void write_vector(const std::vector<T> &v, boost::true_type){
+		if (!write_length(v.size()) || v.empty())
+			return;
+		if (varint_ && buf_varint_type<T>::value){
+			write_elements(&v[0], v.size(), buf_varint_type<T>());
+			return;
+		}
+		if (!ensure(v.size() * sizeof(T)))
+			return;
+		if (sizeof(T) > 1 && buf_order_needs_swap(byte_order_))
+			buf_swap_array(p_, &v[0], v.size(), sizeof(T));
+		else
+			memcpy(p_, &v[0], v.size() * sizeof(T));
+		p_ += v.size() * sizeof(T);
+	}
+
+	template<typename T>
+	void write_vector(const std::vector<T> &v, boost::false_type){
+		if (!write_length(v.size()))
+			return;
+		for (size_t i = 0; i < v.size() && ok(); i++)
+			*this << v[i];
+	}
+
+	template<typename T>
+	void write_elements(const T *v, size_t n, boost::true_type){
+		for (size_t i = 0; i < n && ok(); i++)
+			write_varint(v[i]);
+	}
+
+	template<typename T>
+	void write_elements(const T *v, size_t n, boost::false_type){
+	}
+
+	unsigned char	*begin_;
+	unsigned char	*p_;
+	unsigned char	*end_;
+	bool			fail_;
+	bool			varint_;
+	unsigned int	width_;
+	int				byte_order_;
+};
+
+#endif
@@ -0,0 +1,366 @@
+#pragma once
+
+#ifndef _CHAINED_BYTEBUFFER_H
+#define _CHAINED_BYTEBUFFER_H
+
+#include <vector>
+#include <cstring>
+#include "ByteBuffer.h"
+
+#ifndef _WIN32
+#include <sys/uio.h>
+#endif
+
+//ССByteBufferֱӸƵβɶ
+#define BUF_CHAIN_COPY_LIMIT  256
+
+//һݣowner֤dataڶδڼЧ
+struct ByteSegment
+{
+	boost::shared_ptr<unsigned char>	owner;
+	const unsigned char					*data;
+	size_t								size;
+
+	ByteSegment() : data(0), size(0){}
+	ByteSegment(const boost::shared_ptr<unsigned char> &o, const unsigned char *d, size_t s)
+		: owner(o), data(d), size(s){}
+};
+
+class ChainedByteReader;
+
+/*
+ɶüɵĻƴװϢ
+	- append(ByteBuffer)öԷĴ洢ƣԷ֮дʱԼ(COW)
+	- ⲿڴ桢洢СByteBufferȻ
+	- <<дβByteBuffer
+	- to_iovec/to_wsabufwritev/WSASendʹãreader()ζȡ
+*/
+class ChainedByteBuffer
+{
+public:
+	ChainedByteBuffer() : size_(0){}
+
+	ChainedByteBuffer &append(const void *src, size_t cnt){
+		tail_.append(src, cnt);
+		return *this;
+	}
+
+	ChainedByteBuffer &append(const ByteBuffer &b){
+		boost::shared_ptr<unsigned char> owner = b.storage();
+		if (!owner || b.size() < BUF_CHAIN_COPY_LIMIT){
+			return append(b.contents(), b.size());
+		}
+		seal();
+		push(ByteSegment(owner, b.contents(), b.size()));
+		return *this;
+	}
+
+	ChainedByteBuffer &append(const ChainedByteBuffer &c){
+		if (&c == this){
+			ChainedByteBuffer copy(c);
+			return append(copy);
+		}
+		seal();
+		for (size_t i = 0; i < c.segs_.size(); i++)
+			push(c.segs_[i]);
+		if (c.tail_.size())
+			append(c.tail_);
+		return *this;
+	}
+
+	ChainedByteBuffer &operator<<(const ByteBuffer &b){
+		return append(b);
+	}
+
+	ChainedByteBuffer &operator<<(const ChainedByteBuffer &c){
+		return append(c);
+	}
+
+	//ͰByteBufferĹдβ
+	template<typename T>
+	ChainedByteBuffer &operator<<(const T &value){
+		tail_ << value;
+		return *this;
+	}
+
+	size_t size() const{
+		return size_ + tail_.size();
+	}
+
+	bool empty() const{
+		return size() == 0;
+	}
+
+	//<<manipulatorõĳȿȡvarintֽ
+	void clear(){
+		segs_.clear();
+		size_ = 0;
+		reset_tail();
+	}
+
+	//жΣβ
+	std::vector<ByteSegment> segments() const{
+		std::vector<ByteSegment> v(segs_);
+		if (tail_.size())
+			v.push_back(ByteSegment(tail_.storage(), tail_.contents(), tail_.size()));
+		return v;
+	}
+
+	size_t segment_count() const{
+		return segs_.size() + (tail_.size() ? 1 : 0);
+	}
+
+	//ϲһByteBuffer
+	ByteBuffer flatten() const{
+		ByteBuffer b;
+		b.reserve(size());
+		for (size_t i = 0; i < segs_.size(); i++)
+			b.append(segs_[i].data, segs_[i].size);
+		b.append(tail_.contents(), tail_.size());
+		return b;
+	}
+
+#ifndef _WIN32
+	//iovecʹõĸmaxʱֻǰmax
+	size_t to_iovec(struct iovec *iov, size_t max) const{
+		size_t n = 0;
+		for (size_t i = 0; i < segs_.size() && n < max; i++, n++){
+			iov[n].iov_base = (void *)segs_[i].data;
+			iov[n].iov_len = segs_[i].size;
+		}
+		if (tail_.size() && n < max){
+			iov[n].iov_base = tail_.contents();
+			iov[n].iov_len = tail_.size();
+			n++;
+		}
+		return n;
+	}
+#elif defined(_WINSOCK2API_)
+	//WSABUFʹõĸmaxʱֻǰmax
+	size_t to_wsabuf(WSABUF *bufs, size_t max) const{
+		size_t n = 0;
+		for (size_t i = 0; i < segs_.size() && n < max; i++, n++){
+			bufs[n].buf = (CHAR *)segs_[i].data;
+			bufs[n].len = (ULONG)segs_[i].size;
+		}
+		if (tail_.size() && n < max){
+			bufs[n].buf = (CHAR *)tail_.contents();
+			bufs[n].len = (ULONG)tail_.size();
+			n++;
+		}
+		return n;
+	}
+#endif
+
+	ChainedByteReader reader() const;
+
+private:
+	//βΪһĶΣ֮дʹµβ
+	void seal(){
+		if (!tail_.size())
+			return;
+		push(ByteSegment(tail_.storage(), tail_.contents(), tail_.size()));
+		reset_tail();
+	}
+
+	//һµβþβı
+	void reset_tail(){
+		ByteBuffer b;
+		b.array_with_bytes_ = tail_.array_with_bytes_;
+		b.varint_ = tail_.varint_;
+		b.byte_order_ = tail_.byte_order_;
+		tail_ = b;
+	}
+
+	void push(const ByteSegment &seg){
+		if (!seg.size)
+			return;
+		segs_.push_back(seg);
+		size_ += seg.size;
+	}
+
+	std::vector<ByteSegment>	segs_;
+	size_t						size_;		//segs_ܴС
+	ByteBuffer					tail_;
+};
+
+/*
+ζȡChainedByteBufferиεãԭ֮޸ĵӰ
+	- ֵByteBufferĹ룺ֽvarintģʽȿ
+	- reader()дβãҲ>>manipulator޸
+*/
+class ChainedByteReader
+{
+public:
+	explicit ChainedByteReader(const std::vector<ByteSegment> &segs)
+		: segs_(segs), index_(0), offset_(0), pos_(0), size_(0),
+		width_(BUF_VEC_WIDTH), varint_(false), byte_order_(BYTEBUFFER_DEFAULT_BYTE_ORDER){
+		for (size_t i = 0; i < segs_.size(); i++)
+			size_ += segs_[i].size;
+	}
+
+	void set_width(unsigned int width){ width_ = width; }
+	void set_byte_order(int order){ byte_order_ = order; }
+	void set_varint(bool on){ varint_ = on; }
+
+	size_t remaining() const{
+		return size_ - pos_;
+	}
+
+	size_t rpos() const{
+		return pos_;
+	}
+
+	void get(unsigned char *dest, size_t len){
+		check(len, "chain read");
+		while (len){
+			const ByteSegment &seg = segs_[index_];
+			size_t n = seg.size - offset_;
+			if (n > len)
+				n = len;
+			memcpy(dest, seg.data + offset_, n);
+			dest += n;
+			len -= n;
+			advance(n);
+		}
+	}
+
+	void skip(size_t len){
+		check(len, "chain skip");
+		while (len){
+			size_t n = segs_[index_].size - offset_;
+			if (n > len)
+				n = len;
+			len -= n;
+			advance(n);
+		}
+	}
+
+	//ֻֽ֧ͣvarintģʽ°varintȡఴֽ
+	template<typename T> void read(T &value){
+		static_assert(buf_blittable<T>::value, "ChainedByteReader::read needs an arithmetic T");
+		if (varint_ && buf_varint_type<T>::value){
+			read_varint(value);
+			return;
+		}
+		if (index_ < segs_.size() && segs_[index_].size - offset_ >= sizeof(T)){
+			memcpy(&value, segs_[index_].data + offset_, sizeof(T));
+			advance(sizeof(T));
+		}else{
+			get((unsigned char *)&value, sizeof(T));
+		}
+		if (sizeof(T) > 1 && buf_order_needs_swap(byte_order_))
+			buf_byte_swap(value);
+	}
+
+	template<typename T> T read(){
+		T r;
+		read(r);
+		return r;
+	}
+
+	template<typename T> ChainedByteReader &operator>>(T &value){
+		read(value);
+		return *this;
+	}
+
+	ChainedByteReader &operator>>(bool &value){
+		value = read<char>() > 0 ? true : false;
+		return *this;
+	}
+
+	template <int N> ChainedByteReader &operator>>(ByteBuffer::vec_head_size<N> w){	width_ = N;return *this;}
+	template <bool ON> ChainedByteReader &operator>>(ByteBuffer::varint_mode<ON> m){	varint_ = ON;return *this;}
+	template <int ORDER> ChainedByteReader &operator>>(ByteBuffer::byte_order<ORDER> o){	byte_order_ = ORDER;return *this;}
+
+	//顢ַȣͬByteBuffer::read_length
+	size_t read_length(){
+		if (varint_){
+			unsigned long long n;
+			read_varint(n);
+			if (n > remaining())
+				throw ByteBufferException("chain length", pos_, size_, (size_t)n, size_);
+			return (size_t)n;
+		}
+		unsigned char tmp[8];
+		get(tmp, width_);
+		bool big = byte_order_ == BUF_BIG_ENDIAN || (byte_order_ == BUF_HOST_ORDER && buf_host_is_big_endian());
+		unsigned long long n = 0;
+		for (unsigned int i = 0; i < width_; i++)
+			n |= (unsigned long long)tmp[big ? width_ - 1 - i : i] << (8 * i);
+		return (size_t)n;
+	}
+
+	//lenֽڡһʱøöεĴ洢
+	ByteBuffer read_buffer(size_t len){
+		check(len, "chain read_buffer");
+		if (!len || index_ >= segs_.size())
+			return ByteBuffer();
+		const ByteSegment &seg = segs_[index_];
+		if (seg.size - offset_ >= len && seg.owner){
+			boost::shared_ptr<unsigned char> p(seg.owner, const_cast<unsigned char *>(seg.data) + offset_);
+			advance(len);
+			return ByteBuffer(p, len);
+		}
+		ByteBuffer b;
+		b.resize(len);
+		get(b.contents(), len);
+		b.wpos(len);
+		return b;
+	}
+
+private:
+	//LEB128зzigzagԭͬByteBuffer::read_varint
+	template<typename T> void read_varint(T &value){
+		size_t pos = pos_;
+		unsigned long long v = 0;
+		for (size_t i = 0; ; i++){
+			if (i == 10 || !remaining())
+				throw ByteBufferException("chain varint", pos, size_, i + 1, size_);
+			unsigned char c = segs_[index_].data[offset_];
+			advance(1);
+			v |= (unsigned long long)(c & 0x7f) << (7 * i);
+			if (!(c & 0x80))
+				break;
+		}
+		if ((v >> (sizeof(T) * 8 - 1)) >> 1)
+			throw ByteBufferException("chain varint overflow", pos, size_, pos_ - pos, size_);
+		if (std::numeric_limits<T>::is_signed)
+			value = (T)(long long)((v >> 1) ^ (0 - (v & 1)));
+		else
+			value = (T)v;
+	}
+
+	void check(size_t len, const char *act) const{
+		if (len > remaining())
+			throw ByteBufferException(act, pos_, size_, len, size_);
+	}
+
+	void advance(size_t n){
+		offset_ += n;
+		pos_ += n;
+		while (index_ < segs_.size() && offset_ == segs_[index_].size){
+			index_++;
+			offset_ = 0;
+		}
+	}
+
+	std::vector<ByteSegment>	segs_;
+	size_t						index_;		//ǰ
+	size_t						offset_;	//ǰڵλ
+	size_t						pos_;
+	size_t						size_;
+	unsigned int				width_;		//ȿȣͬByteBuffer::array_with_bytes_
+	bool						varint_;
+	int							byte_order_;
+};
+
+inline ChainedByteReader ChainedByteBuffer::reader() const{
+	ChainedByteReader r(segments());
+	r.set_width(tail_.array_with_bytes_);
+	r.set_varint(tail_.varint_);
+	r.set_byte_order(tail_.byte_order_);
+	return r;
+}
+
+#endif
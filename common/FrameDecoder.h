@@ -0,0 +1,170 @@
+#pragma once
+
+#ifndef _FRAME_DECODER_H
+#define _FRAME_DECODER_H
+
+#include <cstring>
+#include "ByteBuffer.h"
+
+//widthֽڡorderֽд֡ͷ(س)
+inline void buf_put_frame_length(unsigned char *p, size_t len, unsigned int width, int order){
+	bool big = order == BUF_BIG_ENDIAN || (order == BUF_HOST_ORDER && buf_host_is_big_endian());
+	for (unsigned int i = 0; i < width; i++)
+		p[big ? width - 1 - i : i] = (unsigned char)((unsigned long long)len >> (8 * i));
+}
+
+inline unsigned long long buf_get_frame_length(const unsigned char *p, unsigned int width, int order){
+	bool big = order == BUF_BIG_ENDIAN || (order == BUF_HOST_ORDER && buf_host_is_big_endian());
+	unsigned long long n = 0;
+	for (unsigned int i = 0; i < width; i++)
+		n |= (unsigned long long)p[big ? width - 1 - i : i] << (8 * i);
+	return n;
+}
+
+//׷һ֡widthֽڵĳȼlenֽڵĸ
+inline void buf_append_frame(ByteBuffer &dst, const void *data, size_t len,
+	unsigned int width = 4, int order = BYTEBUFFER_DEFAULT_BYTE_ORDER){
+	if (width < 8 && (unsigned long long)len >> (8 * width))
+		throw ByteBufferException("frame length", 0, dst.wpos(), len, dst.size());
+	unsigned char *p = dst.append_space(width + len);
+	buf_put_frame_length(p, len, width, order);
+	if (len)
+		memcpy(p + width, data, len);
+}
+
+/*
+ʽsocketгǰ׺֡
+	- prepare()ؽջĿв֣recv/WSARecvֱӶcommit(n)
+	- next()ÿȡһ֡ýջByteBuffer
+	- ֡ȡߺʹʱᱻǣҪռʱһµĴ洢
+	  ֻѻûĲָƹȥɴ洢Щ֡
+	- û֡ʹʱԭƶδĲ(ͨһ֡)
+	- ֡ȳmax_frameʱByteBufferException֮Ӧر
+*/
+class FrameDecoder
+{
+public:
+	enum {
+		DEFAULT_CAPACITY	= 64 * 1024,
+		DEFAULT_MAX_FRAME	= 16 * 1024 * 1024,
+		MIN_READ			= 4096,			//prepareĿռ
+	};
+
+	explicit FrameDecoder(unsigned int width = 4, size_t max_frame = DEFAULT_MAX_FRAME,
+		size_t capacity = DEFAULT_CAPACITY)
+		: width_(width), byte_order_(BYTEBUFFER_DEFAULT_BYTE_ORDER), max_frame_(max_frame),
+		  base_(0), capacity_(0), begin_(0), end_(0), initial_(capacity){
+		if (width < 1 || width > 8)
+			throw ByteBufferException("frame width", 0, 0, width, 0);
+	}
+
+	void set_byte_order(int order){
+		byte_order_ = order;
+	}
+
+	//ջĿв֣minֽ
+	unsigned char *prepare(size_t min = MIN_READ){
+		if (capacity_ - end_ < min)
+			make_room(min);
+		return base_ + end_;
+	}
+
+	//prepare֮дֽ
+	size_t writable() const{
+		return capacity_ - end_;
+	}
+
+	void commit(size_t n){
+		if (n > capacity_ - end_)
+			throw ByteBufferException("frame commit", begin_, end_, n, capacity_);
+		end_ += n;
+	}
+
+	//ʱƽͬprepare+memcpy+commit
+	void feed(const void *data, size_t len){
+		memcpy(prepare(len), data, len);
+		commit(len);
+	}
+
+	//ȡһ֡ݲʱfalse
+	bool next(ByteBuffer &frame){
+		size_t avail = end_ - begin_;
+		if (avail < width_)
+			return false;
+		size_t len = frame_length();
+		if (avail - width_ < len)
+			return false;
+
+		unsigned char *p = base_ + begin_ + width_;
+		frame = len ? ByteBuffer(boost::shared_ptr<unsigned char>(storage_, p), len) : ByteBuffer();
+		begin_ += width_ + len;
+		if (begin_ == end_ && storage_.use_count() == 1)
+			begin_ = end_ = 0;
+		return true;
+	}
+
+	//յδȡߵֽ
+	size_t buffered() const{
+		return end_ - begin_;
+	}
+
+	size_t capacity() const{
+		return capacity_;
+	}
+
+private:
+	//ǰ֡ĸسȣʱ쳣
+	size_t frame_length() const{
+		unsigned long long len = buf_get_frame_length(base_ + begin_, width_, byte_order_);
+		if (len > max_frame_)
+			throw ByteBufferException("frame too large", begin_, end_, (size_t)(len > (size_t)-1 ? (size_t)-1 : len), max_frame_);
+		return (size_t)len;
+	}
+
+	void make_room(size_t min){
+		size_t pending = end_ - begin_;
+		//ܷµǰ֡һֶ֡
+		size_t need = pending + min;
+		if (pending >= width_){
+			size_t whole = width_ + frame_length();
+			if (whole > need)
+				need = whole;
+		}
+
+		if (storage_ && storage_.use_count() == 1 && need <= capacity_){
+			//û֡ʹãԭƶ
+			memmove(base_, base_ + begin_, pending);
+		}else{
+			size_t cap = capacity_ ? capacity_ : initial_;
+			if (cap < MIN_READ)
+				cap = MIN_READ;
+			while (cap < need)
+				cap *= 2;
+			ByteBufferAllocator &a = ByteBuffer::allocator();
+			unsigned char *mem = a.allocate(cap);
+			boost::shared_ptr<unsigned char> s(mem, ByteBufferDeleter(&a, cap));
+			if (pending)
+				memcpy(s.get(), base_ + begin_, pending);
+			storage_ = s;
+			base_ = s.get();
+			capacity_ = cap;
+		}
+		begin_ = 0;
+		end_ = pending;
+	}
+
+	FrameDecoder(const FrameDecoder &);
+	FrameDecoder &operator=(const FrameDecoder &);
+
+	unsigned int						width_;
+	int									byte_order_;
+	size_t								max_frame_;
+	boost::shared_ptr<unsigned char>	storage_;
+	unsigned char						*base_;
+	size_t								capacity_;
+	size_t								begin_;		//δݵĿʼ
+	size_t								end_;		//ѽݵĽβ
+	size_t								initial_;	//һηĴС
+};
+
+#endif
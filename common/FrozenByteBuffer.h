@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef _FROZEN_BYTEBUFFER_H
+#define _FROZEN_BYTEBUFFER_H
+
+#include "ByteBuffer.h"
+#include "ByteView.h"
+
+/*
+󲻿޸ĵݣڰһõϢӡ
+	- seal()ByteBufferĴ洢
+	- üԭӵ(boost::shared_ptr)߳̿ͬʱкͶȡ
+	- ÿreader()view()õԼα꣬Ӱ
+	- view()صByteBufferͷݹ洢дʱȸһ(COW)ĵ
+*/
+class FrozenByteBuffer
+{
+public:
+	FrozenByteBuffer()
+		: begin_(0), size_(0), width_(BUF_VEC_WIDTH), varint_(false), byte_order_(BYTEBUFFER_DEFAULT_BYTE_ORDER){
+	}
+
+	//data
+	FrozenByteBuffer(const void *data, size_t size)
+		: begin_(0), size_(0), width_(BUF_VEC_WIDTH), varint_(false), byte_order_(BYTEBUFFER_DEFAULT_BYTE_ORDER){
+		ByteBuffer b(data, size, true);
+		*this = seal(b);
+	}
+
+	//bеݣbΪգbĿȡvarintֽá
+	//bʹⲿڴ洢ʱһ
+	static FrozenByteBuffer seal(ByteBuffer &b){
+		FrozenByteBuffer f;
+		f.width_ = b.array_with_bytes_;
+		f.varint_ = b.varint_;
+		f.byte_order_ = b.byte_order_;
+		f.size_ = b.size();
+
+		boost::shared_ptr<unsigned char> storage = b.storage();
+		if (storage){
+			f.data_ = storage;
+			f.begin_ = b.contents();
+		}else if (f.size_){
+			ByteBuffer copy;
+			copy.append(b.contents(), f.size_);
+			f.data_ = copy.storage();
+			f.begin_ = copy.contents();
+		}
+
+		ByteBuffer empty;
+		empty.array_with_bytes_ = f.width_;
+		empty.varint_ = f.varint_;
+		empty.byte_order_ = f.byte_order_;
+		b = empty;
+		return f;
+	}
+
+	const unsigned char *data() const{
+		return data_ ? begin_ : 0;
+	}
+
+	size_t size() const{
+		return size_;
+	}
+
+	bool empty() const{
+		return size_ == 0;
+	}
+
+	//αĶͼ쳣
+	ByteReader reader() const{
+		ByteReader r(data(), size_);
+		r.set_width(width_);
+		r.set_byte_order(byte_order_);
+		r.set_varint(varint_);
+		return r;
+	}
+
+	//洢ByteBufferʹoperator>>
+	ByteBuffer view() const{
+		ByteBuffer b;
+		if (data_)
+			b = ByteBuffer(boost::shared_ptr<unsigned char>(data_, const_cast<unsigned char *>(begin_)), size_);
+		b.array_with_bytes_ = width_;
+		b.varint_ = varint_;
+		b.byte_order_ = byte_order_;
+		return b;
+	}
+
+	//Ĵ洢ChainedByteBufferҪݵĵط
+	boost::shared_ptr<unsigned char> storage() const{
+		return data_;
+	}
+
+private:
+	boost::shared_ptr<unsigned char>	data_;
+	const unsigned char					*begin_;
+	size_t								size_;
+	unsigned char						width_;
+	bool								varint_;
+	unsigned char						byte_order_;
+};
+
+#endif
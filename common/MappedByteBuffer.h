@@ -0,0 +1,243 @@
+#pragma once
+
+#ifndef _MAPPED_BYTEBUFFER_H
+#define _MAPPED_BYTEBUFFER_H
+
+#include <string>
+#include <fstream>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "ByteBuffer.h"
+#include "ByteView.h"
+
+/*
+ļӳ䵽ڴֱӽȶڴ档
+	- ֻӳ䣬ֻռַռ䣬ռύڴ(ҳļ)GBļҲӳ䡣
+	  copy_on_writeWindowsͼύڴ
+	- buffer()Ϊֻ洢put()<<дȸƵµĴ洢(COW)
+	  Ҫͨcontents()ֱд
+	- buffer()ӳ乲üByteBufferͷźŽӳ
+	- ʧʱboost::interprocess::interprocess_exceptionfilesystem_error
+*/
+class MappedByteBuffer
+{
+public:
+	enum advice
+	{
+		ADVISE_NORMAL,
+		ADVISE_SEQUENTIAL,		//˳ں˼ӴԤ
+		ADVISE_RANDOM,
+		ADVISE_WILLNEED,		//Ҫãںǰ
+	};
+
+	MappedByteBuffer() : data_(0), size_(0){}
+
+	explicit MappedByteBuffer(const std::string &path, int hint = ADVISE_SEQUENTIAL)
+		: data_(0), size_(0){
+		open(path, hint);
+	}
+
+	void open(const std::string &path, int hint = ADVISE_SEQUENTIAL){
+		using namespace boost::interprocess;
+		region_.reset();
+		data_ = 0;
+		size_ = 0;
+
+		boost::uintmax_t fsize = boost::filesystem::file_size(path);
+		if (fsize > (boost::uintmax_t)(size_t)-1)
+			throw ByteBufferException("map too large", 0, 0, 0, 0);
+		if (!fsize)
+			return;
+
+		file_mapping file(path.c_str(), read_only);
+		region_.reset(new mapped_region(file, read_only, 0, (size_t)fsize));
+		data_ = (unsigned char *)region_->get_address();
+		size_ = (size_t)fsize;
+		advise(hint);
+	}
+
+	//ӳʾϵͳ֧ʱfalse
+	bool advise(int hint){
+		if (!region_)
+			return false;
+		using boost::interprocess::mapped_region;
+		switch (hint){
+		case ADVISE_SEQUENTIAL:	return region_->advise(mapped_region::advice_sequential);
+		case ADVISE_RANDOM:		return region_->advise(mapped_region::advice_random);
+		case ADVISE_WILLNEED:	return region_->advise(mapped_region::advice_willneed);
+		default:				return region_->advise(mapped_region::advice_normal);
+		}
+	}
+
+	const unsigned char *data() const{
+		return data_;
+	}
+
+	size_t size() const{
+		return size_;
+	}
+
+	bool empty() const{
+		return size_ == 0;
+	}
+
+	//ӳȫݣʹoperator>>
+	ByteBuffer buffer() const{
+		if (!region_)
+			return ByteBuffer();
+		return ByteBuffer(boost::shared_ptr<unsigned char>(region_, data_), size_, true);
+	}
+
+	//쳣ĶͼЧͬ
+	ByteReader reader() const{
+		return ByteReader(data_, size_);
+	}
+
+private:
+	boost::shared_ptr<boost::interprocess::mapped_region>	region_;
+	unsigned char											*data_;
+	size_t													size_;
+};
+
+/*
+ֱдӳļУռ䲻ʱļӳ䡣
+	- 2close()ʱļصʵдĴС
+	- ӳ֮ǰappend_spaceصָʧЧ
+	- ͰByteBufferĹֱӱ뵽ӳУȡֽ<<manipulator޸
+*/
+class MappedFileWriter
+{
+public:
+	enum { MIN_CAPACITY = 64 * 1024 };
+
+	//path
+	explicit MappedFileWriter(const std::string &path, size_t capacity = 1024 * 1024)
+		: path_(path), data_(0), size_(0), capacity_(0),
+		width_(BUF_VEC_WIDTH), varint_(false), byte_order_(BYTEBUFFER_DEFAULT_BYTE_ORDER){
+		std::filebuf f;
+		if (!f.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc))
+			throw ByteBufferException("can not create map file", 0, 0, 0, 0);
+		f.close();
+		remap(capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity);
+	}
+
+	~MappedFileWriter(){
+		try{
+			close();
+		}catch (...){
+		}
+	}
+
+	//βcntֽڲλãɵ
+	unsigned char *append_space(size_t cnt){
+		if (capacity_ - size_ < cnt)
+			grow(cnt);
+		unsigned char *p = data_ + size_;
+		size_ += cnt;
+		return p;
+	}
+
+	void append(const void *src, size_t cnt){
+		if (cnt)
+			memcpy(append_space(cnt), src, cnt);
+	}
+
+	//дλã糤ֶ
+	void put(size_t pos, const void *src, size_t cnt){
+		if (pos > size_ || cnt > size_ - pos)
+			throw ByteBufferException("put", pos, size_, cnt, size_);
+		memcpy(data_ + pos, src, cnt);
+	}
+
+	MappedFileWriter &operator<<(const ByteBuffer &b){
+		append(b.contents(), b.size());
+		return *this;
+	}
+
+	//ʣӳռ䵱ⲿڴֱӱ룬Ųʱӳ±
+	template<typename T>
+	MappedFileWriter &operator<<(const T &value){
+		if (capacity_ == size_)
+			grow(1);
+		for (;;){
+			ByteBuffer b(data_ + size_, capacity_ - size_, false);
+			b.array_with_bytes_ = width_;
+			b.varint_ = varint_;
+			b.byte_order_ = byte_order_;
+			try{
+				b << value;
+			}catch (ByteBufferException &e){
+				if (strcmp(e.action, "out of memeory range") != 0)
+					throw;
+				grow(e.wpos + e.readsize);
+				continue;
+			}
+			size_ += b.wpos();
+			width_ = b.array_with_bytes_;
+			varint_ = b.varint_;
+			byte_order_ = b.byte_order_;
+			return *this;
+		}
+	}
+
+	size_t size() const{
+		return size_;
+	}
+
+	//дݣӳǰЧ
+	unsigned char *contents() const{
+		return data_;
+	}
+
+	//޸дش̣asyncΪtrueʱȴ
+	bool flush(bool async = false){
+		return region_ ? region_->flush(0, size_, async) : true;
+	}
+
+	//ӳ䲢ص֮дӳ
+	void close(){
+		if (!region_)
+			return;
+		region_.reset();
+		data_ = 0;
+		boost::filesystem::resize_file(path_, size_);
+		capacity_ = 0;
+	}
+
+private:
+	//֤дcntֽڣ2
+	void grow(size_t cnt){
+		size_t cap = capacity_ * 2;
+		if (cap < size_ + cnt)
+			cap = size_ + cnt;
+		remap(cap);
+	}
+
+	void remap(size_t capacity){
+		using namespace boost::interprocess;
+		region_.reset();
+		data_ = 0;
+		boost::filesystem::resize_file(path_, capacity);
+
+		file_mapping file(path_.c_str(), read_write);
+		region_.reset(new mapped_region(file, read_write, 0, capacity));
+		region_->advise(mapped_region::advice_sequential);
+		data_ = (unsigned char *)region_->get_address();
+		capacity_ = capacity;
+	}
+
+	MappedFileWriter(const MappedFileWriter &);
+	MappedFileWriter &operator=(const MappedFileWriter &);
+
+	std::string												path_;
+	boost::scoped_ptr<boost::interprocess::mapped_region>	region_;
+	unsigned char											*data_;
+	size_t													size_;
+	size_t													capacity_;
+	unsigned char											width_;		//Ϊ<<manipulatorõı
+	bool													varint_;
+	unsigned char											byte_order_;
+};
+
+#endif
@@ -0,0 +1,613 @@
+#pragma once
+
+#ifndef _STREAM_BYTEBUFFER_H
+#define _STREAM_BYTEBUFFER_H
+
+#include <vector>
+#include <cstring>
+#include <climits>
+#include <cerrno>
+#include <boost/function.hpp>
+#include "ByteBuffer.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <stdio.h>
+#else
+#include <unistd.h>
+#endif
+
+//StreamByteWriter
+struct ByteSink
+{
+	//дȫݣʧʱ쳣
+	virtual void write(const unsigned char *data, size_t size) = 0;
+	//дoffsetѾдݣڻȡ֧ʱfalse
+	virtual bool patch(unsigned long long offset, const unsigned char *data, size_t size){
+		return false;
+	}
+
+	virtual ~ByteSink(){}
+};
+
+//StreamByteReader
+struct ByteSource
+{
+	//ȡsizeֽڣ0ʾûи
+	virtual size_t read(unsigned char *data, size_t size) = 0;
+
+	virtual ~ByteSource(){}
+};
+
+//дļرաpatchҪfdԶλ(ͨļ)ܵsocket֧
+class FdByteSink : public ByteSink
+{
+public:
+	explicit FdByteSink(int fd) : fd_(fd){}
+
+	virtual void write(const unsigned char *data, size_t size){
+		while (size){
+			unsigned int n = size > INT_MAX ? INT_MAX : (unsigned int)size;
+#ifdef _WIN32
+			int r = _write(fd_, data, n);
+#else
+			ssize_t r = ::write(fd_, data, n);
+			if (r < 0 && errno == EINTR)
+				continue;
+#endif
+			if (r <= 0)
+				throw ByteBufferException("sink write", 0, 0, size, 0);
+			data += r;
+			size -= r;
+		}
+	}
+
+	virtual bool patch(unsigned long long offset, const unsigned char *data, size_t size){
+#ifdef _WIN32
+		__int64 end = _lseeki64(fd_, 0, SEEK_END);
+		if (end < 0 || _lseeki64(fd_, (__int64)offset, SEEK_SET) < 0)
+			return false;
+		bool ok = _write(fd_, data, (unsigned int)size) == (int)size;
+		_lseeki64(fd_, end, SEEK_SET);
+		return ok;
+#else
+		while (size){
+			ssize_t r = ::pwrite(fd_, data, size, (off_t)offset);
+			if (r < 0 && errno == EINTR)
+				continue;
+			if (r <= 0)
+				return false;
+			data += r;
+			size -= r;
+			offset += r;
+		}
+		return true;
+#endif
+	}
+
+private:
+	int	fd_;
+};
+
+//ص緢͵ѹ֧patch
+class CallbackByteSink : public ByteSink
+{
+public:
+	typedef boost::function<void (const unsigned char *, size_t)> callback;
+
+	explicit CallbackByteSink(const callback &cb) : cb_(cb){}
+
+	virtual void write(const unsigned char *data, size_t size){
+		cb_(data, size);
+	}
+
+private:
+	callback	cb_;
+};
+
+//ļȡر
+class FdByteSource : public ByteSource
+{
+public:
+	explicit FdByteSource(int fd) : fd_(fd){}
+
+	virtual size_t read(unsigned char *data, size_t size){
+		unsigned int n = size > INT_MAX ? INT_MAX : (unsigned int)size;
+		for (;;){
+#ifdef _WIN32
+			int r = _read(fd_, data, n);
+#else
+			ssize_t r = ::read(fd_, data, n);
+			if (r < 0 && errno == EINTR)
+				continue;
+#endif
+			if (r < 0)
+				throw ByteBufferException("source read", 0, 0, size, 0);
+			return (size_t)r;
+		}
+	}
+
+private:
+	int	fd_;
+};
+
+class CallbackByteSource : public ByteSource
+{
+public:
+	typedef boost::function<size_t (unsigned char *, size_t)> callback;
+
+	explicit CallbackByteSource(const callback &cb) : cb_(cb){}
+
+	virtual size_t read(unsigned char *data, size_t size){
+		return cb_(data, size);
+	}
+
+private:
+	callback	cb_;
+};
+
+/*
+߱ڴռһĴСݵĴС
+	- ֵByteBufferĹ뵽У(chunkֽ)дsink
+	- vectorֶַα룬Žڴ棻list͹Ԫر롣
+	  ֻеֵ飬ʱʱָchunkֽ
+	- Ҫֶreserve(n)ռλдpatch(mark, value)
+	  ռλѾʱsinkpatchдsink֧ʱByteBufferException
+	- ʱflush()ʱҲflushԴ
+*/
+class StreamByteWriter
+{
+public:
+	enum { DEFAULT_CHUNK = 64 * 1024 };
+
+	explicit StreamByteWriter(ByteSink &sink, size_t chunk = DEFAULT_CHUNK)
+		: sink_(sink), chunk_(chunk ? chunk : DEFAULT_CHUNK), flushed_(0){
+		buf_.reserve(chunk_);
+	}
+
+	~StreamByteWriter(){
+		try{
+			flush();
+		}catch (...){
+		}
+	}
+
+	//дֽڿе
+	unsigned long long size() const{
+		return flushed_ + buf_.size();
+	}
+
+	void flush(){
+		if (!buf_.size())
+			return;
+		sink_.write(buf_.contents(), buf_.size());
+		flushed_ += buf_.size();
+		buf_.wpos(0);
+		//ֵѿŴˣͷŶڴ
+		if (buf_.capacity() > chunk_)
+			buf_.resize(chunk_);
+	}
+
+	void append(const void *src, size_t cnt){
+		if (buf_.size() + cnt <= chunk_){
+			buf_.append(src, cnt);
+			check_flush();
+			return;
+		}
+		//ݲֱ
+		flush();
+		sink_.write((const unsigned char *)src, cnt);
+		flushed_ += cnt;
+	}
+
+	//ռnֽڣλã֮patchд
+	unsigned long long reserve(size_t n){
+		unsigned long long mark = size();
+		memset(buf_.append_space(n), 0, n);
+		check_flush();
+		return mark;
+	}
+
+	//ǰֽдmarkֵ
+	template<typename T>
+	void patch(unsigned long long mark, T value){
+		if (sizeof(T) > 1 && buf_order_needs_swap(buf_.byte_order_))
+			buf_byte_swap(value);
+		patch_bytes(mark, (const unsigned char *)&value, sizeof(T));
+	}
+
+	void patch_bytes(unsigned long long mark, const unsigned char *src, size_t cnt){
+		if (mark > size() || cnt > size() - mark)
+			throw ByteBufferException("stream patch", (size_t)mark, (size_t)size(), cnt, (size_t)size());
+		//Ĳ
+		if (mark < flushed_){
+			size_t n = flushed_ - mark < cnt ? (size_t)(flushed_ - mark) : cnt;
+			if (!sink_.patch(mark, src, n))
+				throw ByteBufferException("stream patch unsupported", (size_t)mark, (size_t)size(), cnt, (size_t)size());
+			mark += n;
+			src += n;
+			cnt -= n;
+		}
+		if (cnt)
+			buf_.put((size_t)(mark - flushed_), src, cnt);
+	}
+
+	StreamByteWriter &operator<<(const ByteBuffer &b){
+		append(b.contents(), b.size());
+		return *this;
+	}
+
+	template<typename T>
+	StreamByteWriter &operator<<(const std::vector<T> &v){
+		buf_.append_length(v.size(), buf_.array_with_bytes_);
+		if (!v.empty()){
+			if (buf_.varint_)
+				write_varints(&v[0], v.size(), buf_varint_type<T>());
+			else
+				write_array(&v[0], v.size(), buf_blittable<T>());
+		}
+		check_flush();
+		return *this;
+	}
+
+	template<class _Type,class T2,class T3>
+	StreamByteWriter &operator<<(const std::basic_string<_Type,T2,T3> &s){
+		write_string(s.data(), s.size());
+		return *this;
+	}
+
+	template<class _Type,class T>
+	StreamByteWriter &operator<<(const boost::basic_string_ref<_Type,T> &s){
+		write_string(s.data(), s.size());
+		return *this;
+	}
+
+#ifdef BYTEBUFFER_HAS_STRING_VIEW
+	template<class _Type,class T>
+	StreamByteWriter &operator<<(const std::basic_string_view<_Type,T> &s){
+		write_string(s.data(), s.size());
+		return *this;
+	}
+#endif
+
+	template<typename T>
+	StreamByteWriter &operator<<(const std::list<T> &v){
+		write_range(v.begin(), v.end());
+		return *this;
+	}
+
+	//ʽͬbuf_pack_set/buf_pack_map
+	template<typename T, typename C, typename A>
+	StreamByteWriter &operator<<(const std::set<T,C,A> &s){
+		write_set(s);
+		return *this;
+	}
+
+	template<typename K, typename V, typename F, typename A>
+	StreamByteWriter &operator<<(const std::map<K,V,F,A> &m){
+		write_map(m);
+		return *this;
+	}
+
+	template<typename T, typename H, typename E, typename A>
+	StreamByteWriter &operator<<(const std::unordered_set<T,H,E,A> &s){
+		write_set(s);
+		return *this;
+	}
+
+	template<typename K, typename V, typename H, typename E, typename A>
+	StreamByteWriter &operator<<(const std::unordered_map<K,V,H,E,A> &m){
+		write_map(m);
+		return *this;
+	}
+
+	template<typename T, typename C, typename A>
+	StreamByteWriter &operator<<(const boost::container::flat_set<T,C,A> &s){
+		write_set(s);
+		return *this;
+	}
+
+	template<typename K, typename V, typename C, typename A>
+	StreamByteWriter &operator<<(const boost::container::flat_map<K,V,C,A> &m){
+		write_map(m);
+		return *this;
+	}
+
+	//vecpackͬĸʽԪ
+	template<class _It>
+	void write_range(_It first, _It last){
+		buf_.append_length(std::distance(first, last), buf_.array_with_bytes_);
+		for (; first != last; ++first)
+			*this << *first;
+		check_flush();
+	}
+
+	//ͣmanipulator
+	template<typename T>
+	StreamByteWriter &operator<<(const T &value){
+		buf_ << value;
+		check_flush();
+		return *this;
+	}
+
+private:
+	void check_flush(){
+		if (buf_.size() >= chunk_)
+			flush();
+	}
+
+	//ʽͬByteBuffer::append_stringֱַ
+	template<class _Type>
+	void write_string(const _Type *p, size_t len){
+		if (buf_.array_with_bytes_){
+			buf_.append_length(len, buf_.array_with_bytes_);
+			append(p, len * sizeof(_Type));
+		}else{
+			append(p, len * sizeof(_Type));
+			_Type zero = _Type();
+			append(&zero, sizeof(_Type));
+		}
+	}
+
+	template<typename S>
+	void write_set(const S &s){
+		*this << (unsigned int)s.size();
+		for (typename S::const_iterator i = s.begin(); i != s.end(); ++i)
+			*this << *i;
+	}
+
+	template<typename M>
+	void write_map(const M &m){
+		*this << (unsigned int)m.size();
+		for (typename M::const_iterator i = m.begin(); i != m.end(); ++i)
+			*this << i->first << i->second;
+	}
+
+	template<typename T>
+	void write_varints(const T *p, size_t n, boost::true_type){
+		size_t step = chunk_ / 10 + 1;
+		while (n){
+			size_t k = n < step ? n : step;
+			buf_.append_varints(p, k);
+			check_flush();
+			p += k;
+			n -= k;
+		}
+	}
+
+	template<typename T>
+	void write_varints(const T *p, size_t n, boost::false_type){
+		write_array(p, n, buf_blittable<T>());
+	}
+
+	template<typename T>
+	void write_array(const T *p, size_t n, boost::true_type){
+		size_t step = chunk_ / sizeof(T) + 1;
+		while (n){
+			size_t k = n < step ? n : step;
+			buf_.append_array(p, k, boost::true_type());
+			check_flush();
+			p += k;
+			n -= k;
+		}
+	}
+
+	template<typename T>
+	void write_array(const T *p, size_t n, boost::false_type){
+		for (size_t i = 0; i < n; i++)
+			*this << p[i];
+	}
+
+	StreamByteWriter(const StreamByteWriter &);
+	StreamByteWriter &operator=(const StreamByteWriter &);
+
+	ByteSink			&sink_;
+	size_t				chunk_;
+	unsigned long long	flushed_;	//дsinkֽ
+	ByteBuffer			buf_;
+};
+
+/*
+sourceȡ룬StreamByteWriterͨByteBufferıݡ
+	- ƽʱһ飻һֵԽĩβʱݺ½ֵ
+	  Եֵ(vector)ıȿʱʱܷ
+	- ֻݲʱԣȳmax_length(varint)ֱ׳
+	  ʱmax_length
+	- vectorζ룬ڴǽһ
+	- ݲʱByteBufferException
+*/
+class StreamByteReader
+{
+public:
+	enum {
+		DEFAULT_CHUNK		= 64 * 1024,
+		DEFAULT_MAX_LENGTH	= 16 * 1024 * 1024,		//ֵַ鳤ȵ
+	};
+
+	explicit StreamByteReader(ByteSource &source, size_t chunk = DEFAULT_CHUNK,
+		size_t max_length = DEFAULT_MAX_LENGTH)
+		: source_(source), chunk_(chunk ? chunk : DEFAULT_CHUNK), max_length_(max_length),
+		  consumed_(0), eof_(false){
+		buf_.reserve(chunk_);
+	}
+
+	//Ѷȡֽ
+	unsigned long long rpos() const{
+		return consumed_ + buf_.rpos();
+	}
+
+	//ûʣ
+	bool eof(){
+		return buf_.rpos() == buf_.size() && !more();
+	}
+
+	void get(void *dest, size_t len){
+		unsigned char *d = (unsigned char *)dest;
+		while (len){
+			size_t n = available();
+			if (!n && !more())
+				throw ByteBufferException("stream get", (size_t)rpos(), 0, len, 0);
+			n = available() < len ? available() : len;
+			buf_.get(d, n);
+			d += n;
+			len -= n;
+		}
+	}
+
+	void skip(size_t len){
+		while (len){
+			size_t n = available();
+			if (!n && !more())
+				throw ByteBufferException("stream skip", (size_t)rpos(), 0, len, 0);
+			n = available() < len ? available() : len;
+			buf_.rpos(buf_.rpos() + n);
+			len -= n;
+		}
+	}
+
+	//ַȣԼȡԪءmax_lengthʱ쳣
+	size_t read_length(){
+		unsigned long long n;
+		for (;;){
+			size_t pos = buf_.rpos();
+			try{
+				if (buf_.varint_)
+					buf_.read_varint(n);
+				else
+					n = buf_.read_length(buf_.array_with_bytes_);
+				break;
+			}catch (ByteBufferException &e){
+				buf_.rpos(pos);
+				if (!need_more(e) || !more())
+					throw;
+			}
+		}
+		if (n > max_length_)
+			throw ByteBufferException("stream length", (size_t)rpos(), 0, (size_t)(n > (size_t)-1 ? (size_t)-1 : n), max_length_);
+		return (size_t)n;
+	}
+
+	template<typename T>
+	StreamByteReader &operator>>(std::vector<T> &v){
+		size_t n = read_length();
+		v.clear();
+		if (buf_.varint_)
+			read_varints(v, n, buf_varint_type<T>());
+		else
+			read_array(v, n, buf_blittable<T>());
+		return *this;
+	}
+
+	template <int N> StreamByteReader &operator>>(ByteBuffer::vec_head_size<N> m){	buf_ >> m;return *this;}
+	template <bool ON> StreamByteReader &operator>>(ByteBuffer::varint_mode<ON> m){	buf_ >> m;return *this;}
+	template <int ORDER> StreamByteReader &operator>>(ByteBuffer::byte_order<ORDER> o){	buf_ >> o;return *this;}
+
+	//
+	template<typename T>
+	StreamByteReader &operator>>(T &value){
+		for (;;){
+			size_t pos = buf_.rpos();
+			try{
+				buf_ >> value;
+				return *this;
+			}catch (ByteBufferException &e){
+				buf_.rpos(pos);
+				if (!need_more(e) || !more())
+					throw;
+			}
+		}
+	}
+
+private:
+	size_t available() const{
+		return buf_.size() - buf_.rpos();
+	}
+
+	//쳣ǷֻΪݲҪĲֳĩβҲmax_length
+	//Ҳɹֻʣµڴ
+	bool need_more(const ByteBufferException &e) const{
+		return e.rpos <= e.cursize && e.readsize > e.cursize - e.rpos && e.readsize <= max_length_;
+	}
+
+	//Ѷݣٶһ(ǰʣĴС֤ԴǶ)
+	bool more(){
+		if (eof_)
+			return false;
+		size_t rest = available();
+		if (buf_.rpos()){
+			memmove(buf_.contents(), buf_.contents() + buf_.rpos(), rest);
+			consumed_ += buf_.rpos();
+			buf_.wpos(rest);
+			buf_.rpos(0);
+		}
+		size_t want = rest > chunk_ ? rest : chunk_;
+		buf_.reserve(rest + want);
+		unsigned char *p = buf_.append_space(want);
+		size_t got = 0;
+		while (got < want){
+			size_t r = source_.read(p + got, want - got);
+			if (!r){
+				eof_ = true;
+				break;
+			}
+			got += r;
+		}
+		buf_.wpos(rest + got);
+		return got != 0;
+	}
+
+	template<typename T>
+	void read_varints(std::vector<T> &v, size_t n, boost::true_type){
+		for (size_t i = 0; i < n; i++){
+			T t;
+			*this >> t;
+			v.push_back(t);
+		}
+	}
+
+	template<typename T>
+	void read_varints(std::vector<T> &v, size_t n, boost::false_type){
+		read_array(v, n, buf_blittable<T>());
+	}
+
+	//nԤȷ䣬ֹĳȵ´
+	template<typename T>
+	void read_array(std::vector<T> &v, size_t n, boost::true_type){
+		while (n){
+			size_t k = available() / sizeof(T);
+			if (!k){
+				if (!more())
+					throw ByteBufferException("stream read-vector", (size_t)rpos(), 0, n * sizeof(T), 0);
+				continue;
+			}
+			if (k > n)
+				k = n;
+			size_t old = v.size();
+			const T *p = (const T *)buf_.read_bytes(k * sizeof(T));
+			v.insert(v.end(), p, p + k);
+			if (sizeof(T) > 1 && buf_order_needs_swap(buf_.byte_order_))
+				buf_swap_array(&v[old], &v[old], k, sizeof(T));
+			n -= k;
+		}
+	}
+
+	template<typename T>
+	void read_array(std::vector<T> &v, size_t n, boost::false_type){
+		for (size_t i = 0; i < n; i++){
+			v.push_back(T());
+			*this >> v.back();
+		}
+	}
+
+	StreamByteReader(const StreamByteReader &);
+	StreamByteReader &operator=(const StreamByteReader &);
+
+	ByteSource			&source_;
+	size_t				chunk_;
+	size_t				max_length_;
+	unsigned long long	consumed_;	//Ѵӻֽ
+	bool				eof_;
+	ByteBuffer			buf_;
+};
+
+#endif
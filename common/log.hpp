@@ -6,74 +6,79 @@
 #define __func__ __FUNCTION__
 #endif
 
-#define LOG_LEVEL(level, logger) CustomLogMessage(__FILE__, __func__, __LINE__, (level), logger).getStream()
+#define LOG_LEVEL(level, logger) CustomLogMessage(__FILE__, __func__, __LINE__, (level), logger, CPPLOG_CALLSITE()).getStream()
 #include "log/cpplog.hpp"
 
+//׸ʽȫlogһʱ죬߳ͬʱдһlogҲظ
+#ifdef _DEBUG
+__declspec(selectany) cpplog::PatternLayout __g_log_layout("[zm][%L|%F:%l]");
+#else
+__declspec(selectany) cpplog::PatternLayout __g_log_layout("[%F:%l][%L][%Y-%m-%d %H:%M:%S] ");
+#endif
+
 class CustomLogMessage : public cpplog::LogMessage
 {
 public:
 	CustomLogMessage(const char* file, const char* function,
 		unsigned int line, cpplog::loglevel_t logLevel,
-		cpplog::BaseLogger &outputLogger)
-		: cpplog::LogMessage(file, line, logLevel, outputLogger, false),
+		cpplog::BaseLogger &outputLogger, cpplog::CallSiteStats* callSite = NULL)
+		: cpplog::LogMessage(file, line, logLevel, outputLogger, false, callSite),
 		m_function(function)
 	{
-		InitLogMessage();
+		InitPrefix();
 	}
 
 	static const char* shortLogLevelName(cpplog::loglevel_t logLevel)
 	{
-		switch( logLevel )
-		{
-		case LL_TRACE: return "T";
-		case LL_DEBUG: return "D";
-		case LL_INFO:  return "I";
-		case LL_WARN:  return "W";
-		case LL_ERROR: return "E";
-		case LL_FATAL: return "F";
-		default:       return "O";
-		};
+		return cpplog::LogMessage::getShortLevelName(logLevel);
+	}
+
+	//׸ʽcpplog::PatternLayoutڿʼдlog֮ǰ
+	static void setLayout(const char* pattern)
+	{
+		layout().compile(pattern);
+	}
+
+	static cpplog::PatternLayout& layout()
+	{
+		return __g_log_layout;
 	}
 
 protected:
 	virtual void InitLogMessage()
 	{
-#ifdef _DEBUG
-		m_logData->stream
-			<< "[zm]["<<shortLogLevelName(m_logData->level)<<"|"
-			<< m_logData->fileName<<":" 
-			<< m_logData->line<< "]";
-
-#else
-		m_logData->stream
-			<< "["
-			<< m_logData->fileName << ":"
-			<< m_logData->line
-			<< "]["
-			<< shortLogLevelName(m_logData->level)
-			<< "]["
-			<<m_logData->utcTime.tm_year+1900<<"-"
-			<<m_logData->utcTime.tm_mon+1<<"-"
-			<<m_logData->utcTime.tm_mday<<" "
-			<<m_logData->utcTime.tm_hour<<":"
-			<<m_logData->utcTime.tm_min<<":"
-			<<m_logData->utcTime.tm_sec<<"] ";
-#endif
+		layout().format(m_logData, &m_logData->streamBuffer);
 	}
 private:
 	const char *m_function;
 };
 
+//ȫlogڵһϢʱŴļдlogĳʱļ
+inline cpplog::BaseLogger* __log_create_c_log()
+{
 #ifdef _CONSOLE
-__declspec(selectany) cpplog::StdErrLogger __g_c_log;
+	return new cpplog::StdErrLogger();
 #else
-__declspec(selectany) cpplog::OutputDebugStringLogger __g_c_log;
+	return new cpplog::OutputDebugStringLogger();
 #endif
+}
+
+__declspec(selectany) cpplog::LazyLogger<&__log_create_c_log> __g_c_log;
 
 #ifdef _DEBUG
-__declspec(selectany) cpplog::FileLogger __g_ff_log("zm_dbg.log");
+inline cpplog::BaseLogger* __log_create_ff_log()
+{
+	return new cpplog::FileLogger("zm_dbg.log");
+}
+
+__declspec(selectany) cpplog::LazyLogger<&__log_create_ff_log> __g_ff_log;
 #else
-__declspec(selectany) cpplog::FileLogger __g_file_log("zm.log", true);
+inline cpplog::BaseLogger* __log_create_file_log()
+{
+	return new cpplog::FileLogger("zm.log", true);
+}
+
+__declspec(selectany) cpplog::LazyLogger<&__log_create_file_log> __g_file_log;
 __declspec(selectany) cpplog::FilteringLogger __g_ff_log(LL_INFO, &__g_file_log);
 #endif
 
@@ -11,6 +11,7 @@
 #include <cstring>
 #include <ctime>
 #include <vector>
+#include <algorithm>
 #include <cstdlib>
 #include <streambuf>
 #include <ostream>
@@ -43,6 +44,20 @@
 //      #define CPPLOG_FATAL_EXIT_DEBUG
 //          Causes a fatal error to exit() the process if in debug mode.
 //
+//      #define CPPLOG_CALLSITE_STATS
+//          Keeps message and byte counters for every LOG_* call site, so the
+//          noisiest lines can be listed with reportCallSites().
+//
+//      #define CPPLOG_WITH_BACKTRACE_LOGGER
+//          Enables BacktraceLogger, which keeps low-level messages in a
+//          per-thread ring and writes them out only when an error follows.
+//          Depends on boost::thread (thread_specific_ptr).
+//
+//      #define CPPLOG_WITH_DIRECT_FILE_LOGGER
+//          Enables DirectFileLogger, which writes with O_DIRECT (or
+//          FILE_FLAG_NO_BUFFERING) so logging does not fill the page cache.
+//          Depends on boost::thread.
+//
 //      # define CPPLOG_USE_OLD_BOOST
 //          Use the old Boost namespace for interprocess::ipcdetail.  Define
 //          this if you're using version 1.47 of Boost or earlier.
@@ -75,6 +90,7 @@
 //#define CPPLOG_THREADING
 #define CPPLOG_HELPER_MACROS
 #define CPPLOG_FATAL_EXIT
+#define CPPLOG_CALLSITE_STATS
 //#define CPPLOG_FATAL_EXIT_DEBUG
 //#define CPPLOG_USE_OLD_BOOST
 
@@ -96,12 +112,29 @@
 
 #ifdef _WIN32
 #include "outputdebugstream.hpp"
+#else
+#include <sys/time.h>
+#include <unistd.h>
+#include <sched.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#else
+#include <pthread.h>
+#endif
 #endif
 
 #ifdef CPPLOG_WITH_SCRIBE_LOGGER
 #include "scribestream.hpp"
 #endif
 
+#ifdef CPPLOG_WITH_DIRECT_FILE_LOGGER
+#include "directfilestream.hpp"
+#endif
+
+#ifdef CPPLOG_WITH_BACKTRACE_LOGGER
+#include <boost/thread/tss.hpp>
+#endif
+
 // If we don't have a level defined, set it to CPPLOG_LEVEL_DEBUG (log all except trace statements)
 #ifndef CPPLOG_FILTER_LEVEL
 #define CPPLOG_FILTER_LEVEL LL_DEBUG
@@ -178,6 +211,216 @@ namespace cpplog
 #endif
         }
 
+        // Gets the current wall-clock time, with microseconds.
+        inline void getTimeOfDay(::time_t* const sec, unsigned long* const usec)
+        {
+#if defined(_WIN32)
+            // FILETIME is in 100ns units since 1601-01-01.
+            ::FILETIME ft;
+            ::GetSystemTimeAsFileTime(&ft);
+            unsigned long long t = (static_cast<unsigned long long>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+            t -= 116444736000000000ULL;
+            *sec  = static_cast< ::time_t>(t / 10000000ULL);
+            *usec = static_cast<unsigned long>((t % 10000000ULL) / 10);
+#else
+            ::timeval tv;
+            ::gettimeofday(&tv, NULL);
+            *sec  = tv.tv_sec;
+            *usec = static_cast<unsigned long>(tv.tv_usec);
+#endif
+        }
+
+        // Gets a numeric ID for the calling thread.  Unlike get_thread_id(), this
+        // is always available and always printable.
+        inline unsigned long getThreadNumber()
+        {
+#if defined(_WIN32)
+            return static_cast<unsigned long>(::GetCurrentThreadId());
+#elif defined(__linux__)
+            return static_cast<unsigned long>(::syscall(SYS_gettid));
+#else
+            return static_cast<unsigned long>(reinterpret_cast<size_t>(::pthread_self()));
+#endif
+        }
+
+        // Atomic primitives usable on plain (constant-initialized) statics.
+        // std::atomic members would need dynamic initialization on compilers
+        // without constexpr, which call-site statics must avoid.  Every
+        // atomic in this header uses these, on volatile long / long long /
+        // pointer fields.  64-bit operations are relaxed; the long and
+        // pointer ones order memory as their comments say.  (On MSVC all
+        // Interlocked functions are full barriers.)
+        inline long long atomicAdd(volatile long long* target, long long value)
+        {
+#if defined(_MSC_VER)
+            return ::InterlockedExchangeAdd64(reinterpret_cast<volatile LONGLONG*>(target), value);
+#else
+            return __atomic_fetch_add(target, value, __ATOMIC_RELAXED);
+#endif
+        }
+
+        inline long long atomicLoad(volatile long long* target)
+        {
+#if defined(_MSC_VER)
+            return ::InterlockedCompareExchange64(reinterpret_cast<volatile LONGLONG*>(target), 0, 0);
+#else
+            return __atomic_load_n(target, __ATOMIC_RELAXED);
+#endif
+        }
+
+        inline void atomicStore(volatile long long* target, long long value)
+        {
+#if defined(_MSC_VER)
+            ::InterlockedExchange64(reinterpret_cast<volatile LONGLONG*>(target), value);
+#else
+            __atomic_store_n(target, value, __ATOMIC_RELAXED);
+#endif
+        }
+
+        inline long long atomicExchange(volatile long long* target, long long value)
+        {
+#if defined(_MSC_VER)
+            return ::InterlockedExchange64(reinterpret_cast<volatile LONGLONG*>(target), value);
+#else
+            return __atomic_exchange_n(target, value, __ATOMIC_RELAXED);
+#endif
+        }
+
+        // Replaces *target with desired if it equals expected.
+        inline bool atomicCas(volatile long long* target, long long expected, long long desired)
+        {
+#if defined(_MSC_VER)
+            return ::InterlockedCompareExchange64(reinterpret_cast<volatile LONGLONG*>(target), desired, expected) == expected;
+#else
+            return __atomic_compare_exchange_n(target, &expected, desired, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+#endif
+        }
+
+        // Acquire load.
+        inline long atomicLoad(volatile long* target)
+        {
+#if defined(_MSC_VER)
+            return ::InterlockedCompareExchange(target, 0, 0);
+#else
+            return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+#endif
+        }
+
+        // Release store.
+        inline void atomicStore(volatile long* target, long value)
+        {
+#if defined(_MSC_VER)
+            ::InterlockedExchange(target, value);
+#else
+            __atomic_store_n(target, value, __ATOMIC_RELEASE);
+#endif
+        }
+
+        // Acquire compare-and-swap.
+        inline bool atomicCas(volatile long* target, long expected, long desired)
+        {
+#if defined(_MSC_VER)
+            return ::InterlockedCompareExchange(target, desired, expected) == expected;
+#else
+            return __atomic_compare_exchange_n(target, &expected, desired, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+#endif
+        }
+
+        // Orders the loads before it ahead of the loads after it.
+        inline void atomicFenceAcquire()
+        {
+#if defined(_MSC_VER)
+            ::MemoryBarrier();
+#else
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif
+        }
+
+        inline bool atomicSetFlag(volatile long* target)
+        {
+#if defined(_MSC_VER)
+            return ::InterlockedCompareExchange(target, 1, 0) == 0;
+#else
+            long expected = 0;
+            return __atomic_compare_exchange_n(target, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+#endif
+        }
+
+        inline bool atomicCasPtr(void* volatile* target, void* expected, void* desired)
+        {
+#if defined(_MSC_VER)
+            return ::InterlockedCompareExchangePointer(target, desired, expected) == expected;
+#else
+            return __atomic_compare_exchange_n(target, &expected, desired, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+#endif
+        }
+
+        // Acquire load.
+        inline void* atomicLoadPtr(void* volatile* target)
+        {
+#if defined(_MSC_VER)
+            return ::InterlockedCompareExchangePointer(target, NULL, NULL);
+#else
+            return __atomic_load_n(target, __ATOMIC_ACQUIRE);
+#endif
+        }
+
+        // Release store.
+        inline void atomicStorePtr(void* volatile* target, void* value)
+        {
+#if defined(_MSC_VER)
+            ::InterlockedExchangePointer(target, value);
+#else
+            __atomic_store_n(target, value, __ATOMIC_RELEASE);
+#endif
+        }
+
+        inline void yieldThread()
+        {
+#if defined(_WIN32)
+            ::SwitchToThread();
+#else
+            ::sched_yield();
+#endif
+        }
+
+        // 64-bit FNV-1a hash of a block of bytes.
+        inline unsigned long long hashBytes(const char* data, size_t len)
+        {
+            unsigned long long hash = 14695981039346656037ULL;
+            for( size_t i = 0; i < len; i++ )
+            {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        // Writes an unsigned decimal number, zero padded to at least 'width'
+        // digits, into [out, end).  Returns the number of characters written.
+        inline size_t writeDecimal(char* out, const char* end, unsigned long value, size_t width)
+        {
+            char digits[24];
+            size_t n = 0;
+            do
+            {
+                digits[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while( value != 0 );
+
+            while( n < width && n < sizeof(digits) )
+                digits[n++] = '0';
+
+            size_t written = n;
+            if( written > static_cast<size_t>(end - out) )
+                written = static_cast<size_t>(end - out);
+
+            for( size_t i = 0; i < written; i++ )
+                out[i] = digits[n - 1 - i];
+
+            return written;
+        }
+
         // Below we have a bunch of macros, typedefs and such that make getting our
         // current process/thread ID simpler.
 #ifdef CPPLOG_SYSTEM_IDS
@@ -315,6 +558,71 @@ namespace cpplog
         };
     }
 
+    // Log volume counters for one LOG_* call site.  CPPLOG_CALLSITE() places one
+    // of these in static storage at each call site; it is constant-initialized
+    // and linked into a global list the first time the call site logs.
+    struct CallSiteStats
+    {
+        const char*             file;
+        unsigned long           line;
+
+        volatile long           registered;
+        CallSiteStats*          next;
+
+        // Indexed by level; levels above LL_FATAL are counted as LL_FATAL.
+        volatile long long      messages[LL_FATAL + 1];
+        volatile long long      bytes[LL_FATAL + 1];
+
+        // Totals at the previous report, for rates.  Only touched by the
+        // reporting thread.
+        long long               reportedMessages;
+        long long               reportedBytes;
+
+        void count(loglevel_t level, std::streamsize length)
+        {
+            if( level > LL_FATAL )
+                level = LL_FATAL;
+            helpers::atomicAdd(&messages[level], 1);
+            helpers::atomicAdd(&bytes[level], length);
+
+            if( !registered && helpers::atomicSetFlag(&registered) )
+                link();
+        }
+
+        long long totalMessages()
+        {
+            long long total = 0;
+            for( int i = 0; i <= LL_FATAL; i++ )
+                total += helpers::atomicLoad(&messages[i]);
+            return total;
+        }
+
+        long long totalBytes()
+        {
+            long long total = 0;
+            for( int i = 0; i <= LL_FATAL; i++ )
+                total += helpers::atomicLoad(&bytes[i]);
+            return total;
+        }
+
+        // Head of the list of call sites that have logged at least once.
+        static CallSiteStats* volatile& head()
+        {
+            static CallSiteStats* volatile s_head = NULL;
+            return s_head;
+        }
+
+    private:
+        void link()
+        {
+            void* volatile* target = reinterpret_cast<void* volatile*>(&head());
+            do
+            {
+                next = head();
+            } while( !helpers::atomicCasPtr(target, next, this) );
+        }
+    };
+
     // Logger data.  This is sent to a logger when a LogMessage is Flush()'ed, or
     // when the destructor is called.
     struct LogData
@@ -330,7 +638,14 @@ namespace cpplog
         const char* fullPath;
         const char* fileName;
         time_t messageTime;
+        unsigned long messageMicros;
         ::tm utcTime;
+        unsigned long threadNumber;
+
+        // Number of characters at the start of the stream that make up the
+        // line prefix written by InitLogMessage().  Loggers with their own
+        // layout skip these and write their own prefix instead.
+        std::streamsize prefixLength;
 
 #ifdef CPPLOG_SYSTEM_IDS
         // Process/thread ID.
@@ -341,13 +656,31 @@ namespace cpplog
 
         // Constructor that initializes our stream.
         LogData(loglevel_t logLevel)
-            : streamBuffer(), stream(&streamBuffer), level(logLevel)
+            : streamBuffer(), stream(&streamBuffer), level(logLevel),
+              messageMicros(0), threadNumber(0), prefixLength(0)
 #ifdef CPPLOG_SYSTEM_IDS
               , processId(0), threadId(0)
 #endif
         {
         }
 
+        // Copies the captured fields, but not the text, of another record.
+        void copyFields(const LogData& other)
+        {
+            level         = other.level;
+            line          = other.line;
+            fullPath      = other.fullPath;
+            fileName      = other.fileName;
+            messageTime   = other.messageTime;
+            messageMicros = other.messageMicros;
+            utcTime       = other.utcTime;
+            threadNumber  = other.threadNumber;
+#ifdef CPPLOG_SYSTEM_IDS
+            processId     = other.processId;
+            threadId      = other.threadId;
+#endif
+        }
+
         virtual ~LogData()
         { }
     };
@@ -369,6 +702,7 @@ namespace cpplog
     {
     private:
         BaseLogger*     m_logger;
+        CallSiteStats*  m_callSite;
         bool            m_flushed;
         bool            m_deleteMessage;
 
@@ -391,14 +725,16 @@ namespace cpplog
         }
 
     public:
-        LogMessage(const char* file, unsigned int line, loglevel_t logLevel, BaseLogger* outputLogger)
-            : m_logger(outputLogger)
+        LogMessage(const char* file, unsigned int line, loglevel_t logLevel, BaseLogger* outputLogger, bool useDefaultLogFormat=true,
+                   CallSiteStats* callSite=NULL)
+            : m_logger(outputLogger), m_callSite(callSite)
         {
-            Init(file, line, logLevel);
+            Init(file, line, logLevel, useDefaultLogFormat);
         }
 
-        LogMessage(const char* file, unsigned int line, loglevel_t logLevel, BaseLogger& outputLogger, bool useDefaultLogFormat=true)
-            : m_logger(&outputLogger)
+        LogMessage(const char* file, unsigned int line, loglevel_t logLevel, BaseLogger& outputLogger, bool useDefaultLogFormat=true,
+                   CallSiteStats* callSite=NULL)
+            : m_logger(&outputLogger), m_callSite(callSite)
         {
             Init(file, line, logLevel, useDefaultLogFormat);
         }
@@ -435,6 +771,14 @@ namespace cpplog
                         << m_logData->fileName << "(" << m_logData->line << "): ";
         }
 
+        // Writes the line prefix and remembers where it ends.  Derived classes
+        // that pass useDefaultLogFormat=false call this from their own constructor.
+        void InitPrefix()
+        {
+            InitLogMessage();
+            m_logData->prefixLength = m_logData->streamBuffer.length();
+        }
+
     private:
         void Init(const char* file, unsigned int line, loglevel_t logLevel, bool useDefaultLogFormat=true)
         {
@@ -446,7 +790,8 @@ namespace cpplog
             m_logData->fullPath     = file;
             m_logData->fileName     = cpplog::helpers::fileNameFromPath(file);
             m_logData->line         = line;
-            m_logData->messageTime  = ::time(NULL);
+            m_logData->threadNumber = helpers::getThreadNumber();
+            helpers::getTimeOfDay(&m_logData->messageTime, &m_logData->messageMicros);
 
             // Get current time.
             ::tm gmt;
@@ -461,7 +806,7 @@ namespace cpplog
 
             if( useDefaultLogFormat )
             {
-                InitLogMessage();
+                InitPrefix();
             }
         }
 
@@ -484,6 +829,9 @@ namespace cpplog
                 // Save the log level.
                 loglevel_t savedLogLevel = m_logData->level;
 
+                if( m_callSite )
+                    m_callSite->count(savedLogLevel, sb->length());
+
                 // Send the message, set flushed=true.
                 m_deleteMessage = m_logger->sendLogMessage(m_logData);
                 m_flushed = true;
@@ -532,23 +880,433 @@ namespace cpplog
                     return "OTHER";
             };
         };
+
+        static const char* getShortLevelName(loglevel_t level)
+        {
+            switch( level )
+            {
+                case LL_TRACE: return "T";
+                case LL_DEBUG: return "D";
+                case LL_INFO:  return "I";
+                case LL_WARN:  return "W";
+                case LL_ERROR: return "E";
+                case LL_FATAL: return "F";
+                default:       return "O";
+            };
+        };
+    };
+
+    // Compiled log line layout.  A pattern such as
+    //      "%Y-%m-%dT%H:%M:%S.%f %L %t %F:%l "
+    // is parsed once into a list of writers, so formatting a record is just
+    // a handful of memcpy's.  A run of date/time fields (together with the
+    // literals between them) is rendered once per second and cached.
+    //
+    // Supported fields:
+    //      %Y %m %d %H %M %S   UTC date and time, zero padded
+    //      %f                  microseconds, 6 digits
+    //      %L  %V              short ("I") / full ("INFO") level name
+    //      %F  %P              file name / full path
+    //      %l                  line number
+    //      %t                  thread ID
+    //      %%                  a literal '%'
+    //
+    // format() may be called from any number of threads at once; compile()
+    // may not, so set layouts up before logging starts.
+    class PatternLayout
+    {
+    private:
+        enum OpKind
+        {
+            k_literal,
+            k_year, k_month, k_day, k_hour, k_minute, k_second,
+            k_dateTime,
+            k_micros,
+            k_shortLevel, k_level,
+            k_fileName, k_fullPath,
+            k_line,
+            k_thread
+        };
+
+        struct Op
+        {
+            OpKind      kind;
+            std::string text;       // k_literal
+            size_t      first;      // k_dateTime: range in m_dateOps
+            size_t      last;
+            size_t      cache;      // k_dateTime: index in m_caches
+
+            Op(OpKind k) : kind(k), first(0), last(0), cache(0) { }
+        };
+
+        // Rendered date/time run for one second.  Guarded by a sequence
+        // counter: odd while being rewritten, readers retry on mismatch.
+        struct DateCache
+        {
+            volatile long   seq;
+            ::time_t        key;
+            size_t          len;
+            char            text[64];
+
+            DateCache() : seq(0), key(static_cast< ::time_t>(-1)), len(0) { }
+        };
+
+        std::vector<Op>         m_ops;
+        std::vector<Op>         m_dateOps;
+        std::vector<DateCache*> m_caches;
+
+        PatternLayout(const PatternLayout&);
+        PatternLayout& operator=(const PatternLayout&);
+
+    public:
+        PatternLayout()
+        { }
+
+        PatternLayout(const char* pattern)
+        {
+            compile(pattern);
+        }
+
+        ~PatternLayout()
+        {
+            clear();
+        }
+
+        void compile(const char* pattern)
+        {
+            clear();
+
+            std::vector<Op> ops;
+            for( const char* p = pattern; *p; p++ )
+            {
+                if( *p != '%' || p[1] == '\0' )
+                {
+                    appendLiteral(ops, p, 1);
+                    continue;
+                }
+
+                switch( *++p )
+                {
+                    case 'Y': ops.push_back(Op(k_year));        break;
+                    case 'm': ops.push_back(Op(k_month));       break;
+                    case 'd': ops.push_back(Op(k_day));         break;
+                    case 'H': ops.push_back(Op(k_hour));        break;
+                    case 'M': ops.push_back(Op(k_minute));      break;
+                    case 'S': ops.push_back(Op(k_second));      break;
+                    case 'f': ops.push_back(Op(k_micros));      break;
+                    case 'L': ops.push_back(Op(k_shortLevel));  break;
+                    case 'V': ops.push_back(Op(k_level));       break;
+                    case 'F': ops.push_back(Op(k_fileName));    break;
+                    case 'P': ops.push_back(Op(k_fullPath));    break;
+                    case 'l': ops.push_back(Op(k_line));        break;
+                    case 't': ops.push_back(Op(k_thread));      break;
+                    case '%': appendLiteral(ops, p, 1);         break;
+                    default:  appendLiteral(ops, p - 1, 2);     break;
+                }
+            }
+
+            // Fold each run of date/time fields, and the literals between them,
+            // into a single cached writer.
+            for( size_t i = 0; i < ops.size(); )
+            {
+                if( !isDateField(ops[i].kind) )
+                {
+                    m_ops.push_back(ops[i++]);
+                    continue;
+                }
+
+                size_t end = i + 1, last = i + 1;
+                while( end < ops.size() && (isDateField(ops[end].kind) || ops[end].kind == k_literal) )
+                {
+                    if( isDateField(ops[end].kind) )
+                        last = end + 1;
+                    end++;
+                }
+
+                Op run(k_dateTime);
+                run.first = m_dateOps.size();
+                m_dateOps.insert(m_dateOps.end(), ops.begin() + i, ops.begin() + last);
+                run.last  = m_dateOps.size();
+                run.cache = m_caches.size();
+                m_caches.push_back(new DateCache());
+                m_ops.push_back(run);
+                i = last;
+            }
+        }
+
+        // Formats the prefix for a record into [out, out+capacity).  Returns the
+        // number of characters written; output is truncated, not terminated.
+        size_t format(const LogData* logData, char* out, size_t capacity) const
+        {
+            char* p = out;
+            const char* end = out + capacity;
+
+            for( std::vector<Op>::const_iterator It = m_ops.begin(); It != m_ops.end(); It++ )
+            {
+                switch( It->kind )
+                {
+                    case k_literal:
+                        p += copy(p, end, It->text.data(), It->text.size());
+                        break;
+                    case k_dateTime:
+                        p += formatDateTime(*It, logData, p, end);
+                        break;
+                    case k_micros:
+                        p += helpers::writeDecimal(p, end, logData->messageMicros, 6);
+                        break;
+                    case k_shortLevel:
+                        p += copy(p, end, LogMessage::getShortLevelName(logData->level));
+                        break;
+                    case k_level:
+                        p += copy(p, end, LogMessage::getLevelName(logData->level));
+                        break;
+                    case k_fileName:
+                        p += copy(p, end, logData->fileName);
+                        break;
+                    case k_fullPath:
+                        p += copy(p, end, logData->fullPath);
+                        break;
+                    case k_line:
+                        p += helpers::writeDecimal(p, end, logData->line, 0);
+                        break;
+                    case k_thread:
+                        p += helpers::writeDecimal(p, end, logData->threadNumber, 0);
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            return static_cast<size_t>(p - out);
+        }
+
+        // Formats the prefix for a record straight into a stream buffer.
+        void format(const LogData* logData, std::streambuf* sb) const
+        {
+            char prefix[512];
+            sb->sputn(prefix, static_cast<std::streamsize>(format(logData, prefix, sizeof(prefix))));
+        }
+
+    private:
+        static bool isDateField(OpKind kind)
+        {
+            return kind >= k_year && kind <= k_second;
+        }
+
+        static void appendLiteral(std::vector<Op>& ops, const char* text, size_t len)
+        {
+            if( ops.empty() || ops.back().kind != k_literal )
+                ops.push_back(Op(k_literal));
+            ops.back().text.append(text, len);
+        }
+
+        static size_t copy(char* out, const char* end, const char* text, size_t len)
+        {
+            if( len > static_cast<size_t>(end - out) )
+                len = static_cast<size_t>(end - out);
+            memcpy(out, text, len);
+            return len;
+        }
+
+        static size_t copy(char* out, const char* end, const char* text)
+        {
+            return text ? copy(out, end, text, strlen(text)) : 0;
+        }
+
+        size_t renderDateTime(const Op& run, const ::tm& t, char* out, const char* end) const
+        {
+            char* p = out;
+            for( size_t i = run.first; i < run.last; i++ )
+            {
+                const Op& op = m_dateOps[i];
+                switch( op.kind )
+                {
+                    case k_literal: p += copy(p, end, op.text.data(), op.text.size());    break;
+                    case k_year:    p += helpers::writeDecimal(p, end, t.tm_year + 1900, 4); break;
+                    case k_month:   p += helpers::writeDecimal(p, end, t.tm_mon + 1, 2);     break;
+                    case k_day:     p += helpers::writeDecimal(p, end, t.tm_mday, 2);        break;
+                    case k_hour:    p += helpers::writeDecimal(p, end, t.tm_hour, 2);        break;
+                    case k_minute:  p += helpers::writeDecimal(p, end, t.tm_min, 2);         break;
+                    case k_second:  p += helpers::writeDecimal(p, end, t.tm_sec, 2);         break;
+                    default:        break;
+                }
+            }
+            return static_cast<size_t>(p - out);
+        }
+
+        size_t formatDateTime(const Op& run, const LogData* logData, char* out, const char* end) const
+        {
+            DateCache& cache = *m_caches[run.cache];
+            const ::time_t key = logData->messageTime;
+
+            // Fast path: copy the cached text if it is for this second.
+            long seq = helpers::atomicLoad(&cache.seq);
+            if( (seq & 1) == 0 && cache.key == key )
+            {
+                size_t len = copy(out, end, cache.text, cache.len);
+                helpers::atomicFenceAcquire();
+                if( cache.seq == seq )
+                    return len;
+            }
+
+            // Slow path: render, and refresh the cache if nobody else is.
+            size_t len = renderDateTime(run, logData->utcTime, out, end);
+            if( (seq & 1) == 0 && len <= sizeof(cache.text) &&
+                helpers::atomicCas(&cache.seq, seq, seq + 1) )
+            {
+                cache.key = key;
+                cache.len = len;
+                memcpy(cache.text, out, len);
+                helpers::atomicStore(&cache.seq, seq + 2);
+            }
+            return len;
+        }
+
+        void clear()
+        {
+            for( std::vector<DateCache*>::iterator It = m_caches.begin(); It != m_caches.end(); It++ )
+                delete *It;
+            m_caches.clear();
+            m_ops.clear();
+            m_dateOps.clear();
+        }
     };
 
+    // Snapshot of one call site, as returned by getCallSites().
+    struct CallSiteInfo
+    {
+        const char*     file;
+        unsigned long   line;
+        long long       messages;
+        long long       bytes;
+        long long       levelMessages[LL_FATAL + 1];
+
+        // Since the previous report; zero for getCallSites().
+        long long       newMessages;
+        long long       newBytes;
+    };
+
+    namespace helpers
+    {
+        inline bool compareCallSiteVolume(const CallSiteInfo& a, const CallSiteInfo& b)
+        {
+            if( a.newBytes != b.newBytes )
+                return a.newBytes > b.newBytes;
+            return a.bytes > b.bytes;
+        }
+
+        inline void collectCallSites(std::vector<CallSiteInfo>& out, bool sinceLastReport)
+        {
+            out.clear();
+            for( CallSiteStats* site = CallSiteStats::head(); site; site = site->next )
+            {
+                CallSiteInfo info;
+                info.file     = fileNameFromPath(site->file);
+                info.line     = site->line;
+                info.messages = 0;
+                info.bytes    = site->totalBytes();
+                for( int i = 0; i <= LL_FATAL; i++ )
+                {
+                    info.levelMessages[i] = atomicLoad(&site->messages[i]);
+                    info.messages += info.levelMessages[i];
+                }
+
+                info.newMessages = info.newBytes = 0;
+                if( sinceLastReport )
+                {
+                    info.newMessages = info.messages - site->reportedMessages;
+                    info.newBytes    = info.bytes - site->reportedBytes;
+                    site->reportedMessages = info.messages;
+                    site->reportedBytes    = info.bytes;
+                }
+                out.push_back(info);
+            }
+        }
+
+        inline ::time_t& lastCallSiteReport()
+        {
+            static ::time_t s_last = 0;
+            return s_last;
+        }
+    }
+
+    // All call sites that have logged so far, noisiest first.
+    inline void getCallSites(std::vector<CallSiteInfo>& out)
+    {
+        helpers::collectCallSites(out, false);
+        std::sort(out.begin(), out.end(), helpers::compareCallSiteVolume);
+    }
+
+    // Writes the "topN" call sites that produced the most bytes since the last
+    // report, with their rates.  Not thread-safe against itself: have only one
+    // thread (or one CallSiteReportLogger) produce reports.
+    inline void reportCallSites(std::ostream& out, size_t topN)
+    {
+        ::time_t now = ::time(NULL);
+        ::time_t& last = helpers::lastCallSiteReport();
+        double seconds = last ? difftime(now, last) : 0.0;
+        if( seconds < 1.0 )
+            seconds = 1.0;
+        last = now;
+
+        std::vector<CallSiteInfo> sites;
+        helpers::collectCallSites(sites, true);
+        if( topN < sites.size() )
+        {
+            std::partial_sort(sites.begin(), sites.begin() + topN, sites.end(), helpers::compareCallSiteVolume);
+            sites.resize(topN);
+        }
+        else
+        {
+            std::sort(sites.begin(), sites.end(), helpers::compareCallSiteVolume);
+        }
+
+        out << "log volume by call site (last " << static_cast<long>(seconds) << "s):\n";
+        for( std::vector<CallSiteInfo>::const_iterator It = sites.begin(); It != sites.end(); It++ )
+        {
+            out << "  " << It->file << ":" << It->line
+                << " msgs=" << It->messages << " bytes=" << It->bytes
+                << " msg/s=" << static_cast<long long>(It->newMessages / seconds)
+                << " B/s=" << static_cast<long long>(It->newBytes / seconds)
+                << " [";
+            for( int i = 0; i <= LL_FATAL; i++ )
+                out << (i ? " " : "") << LogMessage::getShortLevelName(i) << "=" << It->levelMessages[i];
+            out << "]\n";
+        }
+    }
+
     // Generic class - logs to a given std::ostream.
     class OstreamLogger : public BaseLogger
     {
     protected:
-        std::ostream&   m_logStream;
+        std::ostream&           m_logStream;
+        const PatternLayout*    m_layout;
 
     public:
         OstreamLogger(std::ostream& outStream)
-            : m_logStream(outStream)
+            : m_logStream(outStream), m_layout(NULL)
         { }
 
+        // Use a layout of our own instead of the prefix the message was created
+        // with.  The layout is not owned; NULL restores the message's prefix.
+        void setLayout(const PatternLayout* layout)
+        {
+            m_layout = layout;
+        }
+
         virtual bool sendLogMessage(LogData* logData)
         {
             helpers::fixed_streambuf* const sb = &logData->streamBuffer;
-            m_logStream.write(sb->c_str(), sb->length());
+            if( m_layout )
+            {
+                char prefix[512];
+                m_logStream.write(prefix, m_layout->format(logData, prefix, sizeof(prefix)));
+                m_logStream.write(sb->c_str() + logData->prefixLength, sb->length() - logData->prefixLength);
+            }
+            else
+            {
+                m_logStream.write(sb->c_str(), sb->length());
+            }
             m_logStream << std::flush;
 
             return true;
@@ -785,6 +1543,49 @@ namespace cpplog
     };
 #endif
 
+#ifdef CPPLOG_WITH_DIRECT_FILE_LOGGER
+    // Log to file, bypassing the OS file cache.  Text is gathered in large
+    // aligned buffers which a background thread writes out; see
+    // directfilestream.hpp.  Messages at or above "flushLevel" are put on disk
+    // before sendLogMessage() returns, everything else when a buffer fills,
+    // on Flush() or on destruction.
+    class DirectFileLogger : public OstreamLogger
+    {
+    private:
+        direct_file_stream  m_outStream;
+        loglevel_t          m_flushLevel;
+
+    public:
+        DirectFileLogger(std::string logFilePath, bool append = true,
+                         size_t bufferSize = 1024 * 1024, loglevel_t flushLevel = LL_ERROR)
+            : OstreamLogger(m_outStream), m_flushLevel(flushLevel)
+        {
+            m_outStream.open(logFilePath, append, bufferSize);
+        }
+
+        virtual bool sendLogMessage(LogData* logData)
+        {
+            bool deleteMessage = OstreamLogger::sendLogMessage(logData);
+
+            if( logData->level >= m_flushLevel )
+                m_outStream.flush_file();
+
+            return deleteMessage;
+        }
+
+        // True if the file system accepted unbuffered I/O.
+        bool isDirect() const
+        {
+            return m_outStream.is_direct();
+        }
+
+        void Flush()
+        {
+            m_outStream.flush_file();
+        }
+    };
+#endif
+
     // Tee logger - given two loggers, will forward a message to both.
     class TeeLogger : public BaseLogger
     {
@@ -963,6 +1764,439 @@ namespace cpplog
         }
     };
 
+    // Defers creating a logger - and with it, e.g., opening its file - until
+    // the first message actually reaches it.  "Create" runs exactly once, on
+    // whichever thread gets there first; any other thread arriving meanwhile
+    // spins until it is done.  If Create throws, the exception propagates and
+    // the next caller tries again.  The created logger is owned.
+    //
+    // The state is a constant-initialized static per Create function, not a
+    // member set by a constructor, so a global LazyLogger works even when a
+    // static initializer in another TU logs through it before its own
+    // constructor has run (and that constructor cannot reset it later).
+    // All LazyLoggers with the same Create share one logger.
+    template<BaseLogger* (*Create)()>
+    class LazyLogger : public BaseLogger
+    {
+    private:
+        static BaseLogger* volatile s_logger;
+        static volatile long        s_creating;
+
+        LazyLogger(const LazyLogger&);
+        LazyLogger& operator=(const LazyLogger&);
+
+    public:
+        LazyLogger()
+        { }
+
+        ~LazyLogger()
+        {
+            BaseLogger* logger = loadLogger();
+            if( logger && helpers::atomicCasPtr(loggerSlot(), logger, NULL) )
+                delete logger;
+        }
+
+        // True once the real logger exists.
+        bool isCreated()
+        {
+            return loadLogger() != NULL;
+        }
+
+        BaseLogger* get()
+        {
+            for( ;; )
+            {
+                BaseLogger* logger = loadLogger();
+                if( logger )
+                    return logger;
+
+                if( helpers::atomicSetFlag(&s_creating) )
+                {
+                    try
+                    {
+                        logger = Create();
+                    }
+                    catch( ... )
+                    {
+                        helpers::atomicStore(&s_creating, 0);
+                        throw;
+                    }
+                    helpers::atomicStorePtr(loggerSlot(), logger);
+                    return logger;
+                }
+
+                helpers::yieldThread();
+            }
+        }
+
+        virtual bool sendLogMessage(LogData* logData)
+        {
+            return get()->sendLogMessage(logData);
+        }
+
+    private:
+        static void* volatile* loggerSlot()
+        {
+            return reinterpret_cast<void* volatile*>(&s_logger);
+        }
+
+        static BaseLogger* loadLogger()
+        {
+            return static_cast<BaseLogger*>(helpers::atomicLoadPtr(loggerSlot()));
+        }
+    };
+
+    template<BaseLogger* (*Create)()>
+    BaseLogger* volatile LazyLogger<Create>::s_logger = NULL;
+
+    template<BaseLogger* (*Create)()>
+    volatile long LazyLogger<Create>::s_creating = 0;
+
+    // Forwards everything, and every "intervalSeconds" also sends a
+    // reportCallSites() listing of the "topN" noisiest call sites.
+    class CallSiteReportLogger : public BaseLogger
+    {
+    private:
+        BaseLogger*             m_forwardTo;
+        bool                    m_owned;
+        long long               m_intervalSeconds;
+        size_t                  m_topN;
+        volatile long long      m_nextReport;
+
+    public:
+        CallSiteReportLogger(long long intervalSeconds, size_t topN, BaseLogger* forwardTo, bool owned = false)
+            : m_forwardTo(forwardTo), m_owned(owned), m_intervalSeconds(intervalSeconds), m_topN(topN),
+              m_nextReport(static_cast<long long>(::time(NULL)) + intervalSeconds)
+        { }
+
+        ~CallSiteReportLogger()
+        {
+            if( m_owned )
+                delete m_forwardTo;
+        }
+
+        virtual bool sendLogMessage(LogData* logData)
+        {
+            long long due = helpers::atomicLoad(&m_nextReport);
+            if( static_cast<long long>(logData->messageTime) >= due &&
+                helpers::atomicCas(&m_nextReport, due, logData->messageTime + m_intervalSeconds) )
+            {
+                LogData* report = new LogData(LL_INFO);
+                report->copyFields(*logData);
+                report->level = LL_INFO;
+                reportCallSites(report->stream, m_topN);
+
+                if( m_forwardTo->sendLogMessage(report) )
+                    delete report;
+            }
+
+            return m_forwardTo->sendLogMessage(logData);
+        }
+    };
+
+    // Repeated-message collapsing logger.  The text of each message (minus its
+    // prefix) is hashed; a message identical to the previous one, and within
+    // "windowSeconds" of the first of its run, is swallowed and counted.  The
+    // next different message (or a duplicate after the window) is preceded by
+    // a single "last message repeated N times" line, carrying the prefix and
+    // level of the first swallowed message.  New messages take no locks; the
+    // first duplicate of a run and the end of a run take a short spin lock.
+    // Counts may be slightly off when several threads race on the same message.
+    class DedupLogger : public BaseLogger
+    {
+    private:
+        BaseLogger*     m_forwardTo;
+        bool            m_owned;
+        ::time_t        m_windowSeconds;
+
+        volatile long long  m_lastHash;
+        volatile long long  m_windowStart;
+        volatile long long  m_repeats;
+
+        // First swallowed message of the current run: its fields and prefix.
+        // Guarded by m_runLock.
+        volatile long   m_runLock;
+        LogData*        m_run;
+
+        void Init()
+        {
+            m_lastHash    = 0;
+            m_windowStart = 0;
+            m_repeats     = 0;
+            m_runLock     = 0;
+            m_run         = NULL;
+        }
+
+    public:
+        DedupLogger(::time_t windowSeconds, BaseLogger* forwardTo)
+            : m_forwardTo(forwardTo), m_owned(false), m_windowSeconds(windowSeconds)
+        {
+            Init();
+        }
+
+        DedupLogger(::time_t windowSeconds, BaseLogger& forwardTo)
+            : m_forwardTo(&forwardTo), m_owned(false), m_windowSeconds(windowSeconds)
+        {
+            Init();
+        }
+
+        DedupLogger(::time_t windowSeconds, BaseLogger* forwardTo, bool owned)
+            : m_forwardTo(forwardTo), m_owned(owned), m_windowSeconds(windowSeconds)
+        {
+            Init();
+        }
+
+        ~DedupLogger()
+        {
+            Flush();
+
+            if( m_owned )
+                delete m_forwardTo;
+        }
+
+        virtual bool sendLogMessage(LogData* logData)
+        {
+            helpers::fixed_streambuf* const sb = &logData->streamBuffer;
+            const unsigned long long hash = helpers::hashBytes(sb->c_str() + logData->prefixLength,
+                                                               static_cast<size_t>(sb->length() - logData->prefixLength));
+
+            // Common case: a new message.  Only the duplicate path is counted.
+            if( static_cast<long long>(hash) == helpers::atomicLoad(&m_lastHash) &&
+                logData->messageTime - helpers::atomicLoad(&m_windowStart) < m_windowSeconds )
+            {
+                if( helpers::atomicLoad(&m_repeats) == 0 )
+                    startRun(logData);
+                else
+                    helpers::atomicAdd(&m_repeats, 1);
+                return true;
+            }
+
+            helpers::atomicStore(&m_lastHash, static_cast<long long>(hash));
+            helpers::atomicStore(&m_windowStart, logData->messageTime);
+
+            if( helpers::atomicLoad(&m_repeats) != 0 )
+                endRun();
+
+            return m_forwardTo->sendLogMessage(logData);
+        }
+
+        // Emits the pending "repeated" line, if any.  Call this when a storm
+        // might have been the last thing logged for a while.
+        void Flush()
+        {
+            endRun();
+        }
+
+    private:
+        void lock()
+        {
+            while( !helpers::atomicSetFlag(&m_runLock) )
+                helpers::yieldThread();
+        }
+
+        void unlock()
+        {
+            helpers::atomicStore(&m_runLock, 0);
+        }
+
+        // Keeps the prefix of the first duplicate for the summary line.
+        void startRun(const LogData* logData)
+        {
+            LogData* run = new LogData(logData->level);
+            run->copyFields(*logData);
+            run->level = logData->level;
+            run->streamBuffer.sputn(logData->streamBuffer.c_str(), logData->prefixLength);
+            run->prefixLength = logData->prefixLength;
+
+            lock();
+            if( m_run == NULL )
+            {
+                m_run = run;
+                run = NULL;
+            }
+            helpers::atomicAdd(&m_repeats, 1);
+            unlock();
+
+            delete run;
+        }
+
+        void endRun()
+        {
+            lock();
+            unsigned long long repeats = helpers::atomicExchange(&m_repeats, 0);
+            LogData* run = m_run;
+            m_run = NULL;
+            unlock();
+
+            // Without a captured run (lost race) the count is dropped.
+            if( run == NULL )
+                return;
+            if( repeats == 0 )
+            {
+                delete run;
+                return;
+            }
+
+            run->stream << "last message repeated " << repeats << " times\n";
+            if( m_forwardTo->sendLogMessage(run) )
+                delete run;
+        }
+    };
+
+#ifdef CPPLOG_WITH_BACKTRACE_LOGGER
+    // Error-triggered backtrace logger.  Messages below "bufferBelow" are not
+    // forwarded; each thread keeps its last "capacity" of them in memory.  When
+    // that thread then logs at "triggerLevel" or above, its buffered messages
+    // are forwarded first, oldest first, followed by the triggering message.
+    // Messages in between the two levels are forwarded as usual.
+    //
+    // E.g. BacktraceLogger(LL_INFO, LL_ERROR, 256, &fileLog) writes INFO and
+    // up, plus the 256 DEBUG/TRACE lines leading up to each error.
+    class BacktraceLogger : public BaseLogger
+    {
+    private:
+        // A buffered message: the captured fields and the full text.
+        struct Record
+        {
+            loglevel_t      level;
+            unsigned long   line;
+            const char*     fullPath;
+            const char*     fileName;
+            ::time_t        messageTime;
+            unsigned long   messageMicros;
+            ::tm            utcTime;
+            unsigned long   threadNumber;
+            std::streamsize prefixLength;
+#ifdef CPPLOG_SYSTEM_IDS
+            helpers::process_id_t processId;
+            helpers::thread_id_t  threadId;
+#endif
+            std::string     text;
+
+            void capture(LogData* logData)
+            {
+                level         = logData->level;
+                line          = logData->line;
+                fullPath      = logData->fullPath;
+                fileName      = logData->fileName;
+                messageTime   = logData->messageTime;
+                messageMicros = logData->messageMicros;
+                utcTime       = logData->utcTime;
+                threadNumber  = logData->threadNumber;
+                prefixLength  = logData->prefixLength;
+#ifdef CPPLOG_SYSTEM_IDS
+                processId     = logData->processId;
+                threadId      = logData->threadId;
+#endif
+                // assign() reuses the string's capacity once the ring is warm.
+                text.assign(logData->streamBuffer.c_str(), static_cast<size_t>(logData->streamBuffer.length()));
+            }
+
+            LogData* restore() const
+            {
+                LogData* logData = new LogData(level);
+                logData->line          = line;
+                logData->fullPath      = fullPath;
+                logData->fileName      = fileName;
+                logData->messageTime   = messageTime;
+                logData->messageMicros = messageMicros;
+                logData->utcTime       = utcTime;
+                logData->threadNumber  = threadNumber;
+                logData->prefixLength  = prefixLength;
+#ifdef CPPLOG_SYSTEM_IDS
+                logData->processId     = processId;
+                logData->threadId      = threadId;
+#endif
+                logData->streamBuffer.sputn(text.data(), static_cast<std::streamsize>(text.size()));
+                return logData;
+            }
+        };
+
+        struct Ring
+        {
+            std::vector<Record> records;
+            size_t              next;
+            size_t              count;
+
+            Ring(size_t capacity)
+                : records(capacity), next(0), count(0)
+            { }
+        };
+
+        BaseLogger*                     m_forwardTo;
+        bool                            m_owned;
+        loglevel_t                      m_bufferBelow;
+        loglevel_t                      m_triggerLevel;
+        size_t                          m_capacity;
+        boost::thread_specific_ptr<Ring> m_rings;
+
+    public:
+        BacktraceLogger(loglevel_t bufferBelow, loglevel_t triggerLevel, size_t capacity,
+                        BaseLogger* forwardTo, bool owned = false)
+            : m_forwardTo(forwardTo), m_owned(owned),
+              m_bufferBelow(bufferBelow), m_triggerLevel(triggerLevel),
+              m_capacity(capacity ? capacity : 1)
+        { }
+
+        ~BacktraceLogger()
+        {
+            if( m_owned )
+                delete m_forwardTo;
+        }
+
+        virtual bool sendLogMessage(LogData* logData)
+        {
+            if( logData->level < m_bufferBelow )
+            {
+                Ring* ring = m_rings.get();
+                if( !ring )
+                {
+                    ring = new Ring(m_capacity);
+                    m_rings.reset(ring);
+                }
+
+                ring->records[ring->next].capture(logData);
+                ring->next = (ring->next + 1) % ring->records.size();
+                if( ring->count < ring->records.size() )
+                    ring->count++;
+                return true;
+            }
+
+            if( logData->level >= m_triggerLevel )
+                DumpThread();
+
+            return m_forwardTo->sendLogMessage(logData);
+        }
+
+        // Forwards, and forgets, whatever the calling thread has buffered.
+        void DumpThread()
+        {
+            Ring* ring = m_rings.get();
+            if( !ring || ring->count == 0 )
+                return;
+
+            const size_t size = ring->records.size();
+            size_t index = (ring->next + size - ring->count) % size;
+            for( size_t i = 0; i < ring->count; i++, index = (index + 1) % size )
+            {
+                LogData* logData = ring->records[index].restore();
+                if( m_forwardTo->sendLogMessage(logData) )
+                    delete logData;
+            }
+            ring->count = 0;
+        }
+
+        // Drops whatever the calling thread has buffered, e.g. once a unit of
+        // work has finished successfully.
+        void ClearThread()
+        {
+            Ring* ring = m_rings.get();
+            if( ring )
+                ring->count = 0;
+        }
+    };
+#endif
+
     // Logger that moves all processing of log messages to a background thread.
     // Only include if we have support for threading.
 #ifdef CPPLOG_THREADING
@@ -1076,8 +2310,15 @@ namespace cpplog
 
 // Default macros - log, and don't log something.
 // Allow custom log message formatting
+// Static per-call-site counters, see CallSiteStats.
+#ifdef CPPLOG_CALLSITE_STATS
+#define CPPLOG_CALLSITE()   ([]() -> cpplog::CallSiteStats* { static cpplog::CallSiteStats s_site = { __FILE__, __LINE__ }; return &s_site; }())
+#else
+#define CPPLOG_CALLSITE()   static_cast<cpplog::CallSiteStats*>(NULL)
+#endif
+
 #ifndef LOG_LEVEL
-#define LOG_LEVEL(level, logger)    cpplog::LogMessage(__FILE__, __LINE__, (level), logger).getStream()
+#define LOG_LEVEL(level, logger)    cpplog::LogMessage(__FILE__, __LINE__, (level), logger, true, CPPLOG_CALLSITE()).getStream()
 #endif
 #define LOG_NOTHING(level, logger)  true ? (void)0 : cpplog::helpers::VoidStreamClass() & LOG_LEVEL(level, logger)
 
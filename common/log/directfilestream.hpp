@@ -0,0 +1,548 @@
+// Unbuffered (O_DIRECT / FILE_FLAG_NO_BUFFERING) file stream for cpplog.
+//
+// Log text is collected in large, block-aligned buffers and written straight
+// to disk, bypassing the page cache.  Two buffers are used: one is filled by
+// the logging threads while a background thread writes the other.  The last,
+// partial block is padded on flush() and the file truncated back to its real
+// length; the same block is simply rewritten once more data arrives.  Only the
+// blocks from the last flushed byte onwards go to disk again.
+//
+// If the file system refuses unbuffered I/O (tmpfs, some network shares) the
+// stream silently falls back to ordinary buffered writes.
+
+#pragma once
+#ifndef _DIRECT_FILE_STREAM_H
+#define _DIRECT_FILE_STREAM_H
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+
+#include <boost/thread.hpp>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <malloc.h>
+#else
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#endif
+
+namespace cpplog
+{
+    namespace helpers
+    {
+        // Thin wrapper over the platform file API: positioned writes/reads,
+        // size and truncation, with or without the OS cache.
+        class direct_file
+        {
+        public:
+#ifdef _WIN32
+            typedef HANDLE native_handle_t;
+#else
+            typedef int    native_handle_t;
+#endif
+
+        private:
+            native_handle_t m_handle;
+            bool            m_direct;
+            std::string     m_path;
+
+        public:
+            direct_file()
+                : m_handle(invalid()), m_direct(false)
+            { }
+
+            ~direct_file()
+            {
+                close();
+            }
+
+            static native_handle_t invalid()
+            {
+#ifdef _WIN32
+                return INVALID_HANDLE_VALUE;
+#else
+                return -1;
+#endif
+            }
+
+            bool is_open() const    { return m_handle != invalid(); }
+            bool is_direct() const  { return m_direct; }
+
+            bool open(const std::string& path, bool direct)
+            {
+                close();
+                m_path = path;
+#ifdef _WIN32
+                DWORD flags = direct ? (FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH) : FILE_ATTRIBUTE_NORMAL;
+                m_handle = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                                         NULL, OPEN_ALWAYS, flags, NULL);
+#else
+                int flags = O_RDWR | O_CREAT;
+#ifdef O_DIRECT
+                if( direct )
+                    flags |= O_DIRECT;
+#else
+                direct = false;
+#endif
+                m_handle = ::open(path.c_str(), flags, 0644);
+#endif
+                m_direct = direct && is_open();
+                return is_open();
+            }
+
+            // Re-open the same file with the OS cache, after unbuffered I/O
+            // has been refused.
+            bool reopen_buffered()
+            {
+                std::string path = m_path;
+                return open(path, false);
+            }
+
+            void close()
+            {
+                if( !is_open() )
+                    return;
+#ifdef _WIN32
+                ::CloseHandle(m_handle);
+#else
+                ::close(m_handle);
+#endif
+                m_handle = invalid();
+            }
+
+            // Returns false on failure; "refused" is set when the failure means
+            // the file system does not support unbuffered I/O.
+            bool write_at(const void* data, size_t len, unsigned long long offset, bool& refused)
+            {
+                refused = false;
+                const char* p = static_cast<const char*>(data);
+                while( len != 0 )
+                {
+#ifdef _WIN32
+                    OVERLAPPED ov;
+                    memset(&ov, 0, sizeof(ov));
+                    ov.Offset     = static_cast<DWORD>(offset);
+                    ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                    DWORD chunk = len > 0x40000000 ? 0x40000000 : static_cast<DWORD>(len);
+                    DWORD done  = 0;
+                    if( !::WriteFile(m_handle, p, chunk, &done, &ov) )
+                    {
+                        refused = m_direct && ::GetLastError() == ERROR_INVALID_PARAMETER;
+                        return false;
+                    }
+#else
+                    ssize_t done = ::pwrite(m_handle, p, len, static_cast<off_t>(offset));
+                    if( done < 0 )
+                    {
+                        if( errno == EINTR )
+                            continue;
+                        refused = m_direct && errno == EINVAL;
+                        return false;
+                    }
+#endif
+                    p      += done;
+                    len    -= static_cast<size_t>(done);
+                    offset += static_cast<unsigned long long>(done);
+                }
+                return true;
+            }
+
+            size_t read_at(void* data, size_t len, unsigned long long offset)
+            {
+#ifdef _WIN32
+                OVERLAPPED ov;
+                memset(&ov, 0, sizeof(ov));
+                ov.Offset     = static_cast<DWORD>(offset);
+                ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+                DWORD done = 0;
+                if( !::ReadFile(m_handle, data, static_cast<DWORD>(len), &done, &ov) )
+                    return 0;
+                return done;
+#else
+                ssize_t done = ::pread(m_handle, data, len, static_cast<off_t>(offset));
+                return done < 0 ? 0 : static_cast<size_t>(done);
+#endif
+            }
+
+            unsigned long long size() const
+            {
+#ifdef _WIN32
+                LARGE_INTEGER li;
+                return ::GetFileSizeEx(m_handle, &li) ? static_cast<unsigned long long>(li.QuadPart) : 0;
+#else
+                struct stat st;
+                return ::fstat(m_handle, &st) == 0 ? static_cast<unsigned long long>(st.st_size) : 0;
+#endif
+            }
+
+            void truncate(unsigned long long length)
+            {
+#ifdef _WIN32
+                LARGE_INTEGER li;
+                li.QuadPart = static_cast<LONGLONG>(length);
+                if( ::SetFilePointerEx(m_handle, li, NULL, FILE_BEGIN) )
+                    ::SetEndOfFile(m_handle);
+#else
+                if( ::ftruncate(m_handle, static_cast<off_t>(length)) != 0 )
+                    return;
+#endif
+            }
+        };
+
+        inline char* aligned_alloc_block(size_t size, size_t alignment)
+        {
+#ifdef _WIN32
+            return static_cast<char*>(::_aligned_malloc(size, alignment));
+#else
+            void* p = NULL;
+            return ::posix_memalign(&p, alignment, size) == 0 ? static_cast<char*>(p) : NULL;
+#endif
+        }
+
+        inline void aligned_free_block(char* p)
+        {
+#ifdef _WIN32
+            ::_aligned_free(p);
+#else
+            ::free(p);
+#endif
+        }
+    }
+
+    // Aligned double-buffered writer.  Thread-safe.
+    class direct_file_writer
+    {
+    public:
+        // Alignment that satisfies every common sector/page size.
+        static const size_t k_blockSize = 4096;
+
+    private:
+        helpers::direct_file        m_file;
+        size_t                      m_capacity;
+
+        char*                       m_buffers[2];
+        char*                       m_tail;             // padded copy of the partial last block
+        char*                       m_fill;             // being filled by loggers
+        size_t                      m_fillLength;
+        size_t                      m_flushedLength;    // m_fill[0, m_flushedLength) is on disk
+        unsigned long long          m_fillOffset;       // file offset of m_fill[0], block aligned
+
+        char*                       m_pending;          // being written by the background thread
+        size_t                      m_pendingSkip;      // leading bytes of m_pending already on disk
+        unsigned long long          m_pendingOffset;
+
+        bool                        m_flushing;         // flush() is writing m_fill outside the lock
+        bool                        m_failed;           // a write failed; data has been lost
+        bool                        m_stop;
+        boost::mutex                m_mutex;
+        boost::condition_variable   m_cond;
+        boost::thread               m_thread;
+
+        direct_file_writer(const direct_file_writer&);
+        direct_file_writer& operator=(const direct_file_writer&);
+
+    public:
+        direct_file_writer()
+            : m_capacity(0), m_tail(NULL), m_fill(NULL), m_fillLength(0), m_flushedLength(0), m_fillOffset(0),
+              m_pending(NULL), m_pendingSkip(0), m_pendingOffset(0), m_flushing(false), m_failed(false), m_stop(false)
+        {
+            m_buffers[0] = m_buffers[1] = NULL;
+        }
+
+        ~direct_file_writer()
+        {
+            close();
+        }
+
+        bool is_open() const    { return m_file.is_open(); }
+        bool is_direct() const  { return m_file.is_direct(); }
+
+        bool failed()
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            return m_failed;
+        }
+
+        // bufferSize is rounded up to a whole number of blocks.
+        bool open(const std::string& path, bool append, size_t bufferSize = 1024 * 1024)
+        {
+            close();
+
+            m_capacity = (bufferSize + k_blockSize - 1) / k_blockSize * k_blockSize;
+            if( m_capacity == 0 )
+                m_capacity = k_blockSize;
+
+            if( !m_file.open(path, true) && !m_file.open(path, false) )
+                return false;
+
+            m_buffers[0] = helpers::aligned_alloc_block(m_capacity, k_blockSize);
+            m_buffers[1] = helpers::aligned_alloc_block(m_capacity, k_blockSize);
+            m_tail       = helpers::aligned_alloc_block(k_blockSize, k_blockSize);
+            if( !m_buffers[0] || !m_buffers[1] || !m_tail )
+            {
+                close();
+                return false;
+            }
+
+            m_fill       = m_buffers[0];
+            m_fillLength = 0;
+            m_fillOffset = 0;
+
+            if( append )
+            {
+                // Continue from the last whole block; pull the partial tail
+                // block back into the buffer so it is rewritten in place.
+                unsigned long long size = m_file.size();
+                m_fillOffset = size / k_blockSize * k_blockSize;
+                m_fillLength = static_cast<size_t>(size - m_fillOffset);
+                if( m_fillLength != 0 && m_file.read_at(m_fill, k_blockSize, m_fillOffset) < m_fillLength )
+                    m_fillLength = 0;
+                m_flushedLength = m_fillLength;
+            }
+            else
+            {
+                m_file.truncate(0);
+            }
+
+            m_stop     = false;
+            m_failed   = false;
+            m_flushing = false;
+            m_pending  = NULL;
+            m_thread  = boost::thread(&direct_file_writer::backgroundFunction, this);
+            return true;
+        }
+
+        // Returns false once any earlier write to the file has failed.
+        bool write(const char* data, size_t len)
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            if( !m_fill )
+                return false;
+
+            while( len != 0 )
+            {
+                size_t chunk = m_capacity - m_fillLength;
+                if( chunk > len )
+                    chunk = len;
+                memcpy(m_fill + m_fillLength, data, chunk);
+                m_fillLength += chunk;
+                data         += chunk;
+                len          -= chunk;
+
+                if( m_fillLength == m_capacity )
+                {
+                    // Hand the full buffer to the background thread, and carry
+                    // on in the other one once it is free.  A running flush()
+                    // still reads from m_fill, so it must not be swapped out.
+                    // Another writer may have swapped while we waited.
+                    while( m_pending || m_flushing )
+                        m_cond.wait(lock);
+                    if( m_fillLength != m_capacity )
+                        continue;
+
+                    m_pending        = m_fill;
+                    m_pendingSkip    = m_flushedLength / k_blockSize * k_blockSize;
+                    m_pendingOffset  = m_fillOffset;
+                    m_fill           = (m_fill == m_buffers[0]) ? m_buffers[1] : m_buffers[0];
+                    m_fillOffset    += m_capacity;
+                    m_fillLength     = 0;
+                    m_flushedLength  = 0;
+                    m_cond.notify_all();
+                }
+            }
+            return !m_failed;
+        }
+
+        // Puts everything written so far on disk.  The partial last block is
+        // padded for the write, then the file is cut back to its true length.
+        void flush()
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            flushLocked(lock);
+        }
+
+        void close()
+        {
+            if( m_fill )
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                flushLocked(lock);
+                m_stop = true;
+                m_cond.notify_all();
+            }
+            if( m_thread.joinable() )
+                m_thread.join();
+
+            m_file.close();
+            helpers::aligned_free_block(m_buffers[0]);
+            helpers::aligned_free_block(m_buffers[1]);
+            helpers::aligned_free_block(m_tail);
+            m_buffers[0] = m_buffers[1] = m_tail = NULL;
+            m_fill = m_pending = NULL;
+            m_fillLength = m_flushedLength = 0;
+        }
+
+    private:
+        void flushLocked(boost::mutex::scoped_lock& lock)
+        {
+            if( !m_fill )
+                return;
+
+            while( m_pending || m_flushing )
+                m_cond.wait(lock);
+
+            if( m_fillLength == m_flushedLength )
+                return;
+
+            // Start at the block holding the last flushed byte; whole blocks
+            // are written straight from m_fill, which loggers only append to,
+            // and the partial last block from a padded copy.
+            const size_t length = m_fillLength;
+            const size_t start  = m_flushedLength / k_blockSize * k_blockSize;
+            const size_t whole  = length / k_blockSize * k_blockSize;
+            const size_t rest   = length - whole;
+            if( rest != 0 )
+            {
+                memcpy(m_tail, m_fill + whole, rest);
+                memset(m_tail + rest, 0, k_blockSize - rest);
+            }
+
+            char* const data = m_fill;
+            const unsigned long long offset = m_fillOffset;
+            m_flushing = true;
+            lock.unlock();
+
+            bool ok = true;
+            if( whole > start )
+                ok = writeBlock(data + start, whole - start, offset + start);
+            if( ok && rest != 0 )
+            {
+                ok = writeBlock(m_tail, k_blockSize, offset + whole);
+                if( ok )
+                    m_file.truncate(offset + length);
+            }
+
+            lock.lock();
+            m_flushing = false;
+            if( ok )
+                m_flushedLength = length;
+            else
+                m_failed = true;
+            m_cond.notify_all();
+        }
+
+        // Called without the lock; the caller records a failure in m_failed.
+        bool writeBlock(const char* data, size_t len, unsigned long long offset)
+        {
+            bool refused = false;
+            bool ok = m_file.write_at(data, len, offset, refused);
+            if( !ok && refused && m_file.reopen_buffered() )
+                ok = m_file.write_at(data, len, offset, refused);
+            return ok;
+        }
+
+        void backgroundFunction()
+        {
+            boost::mutex::scoped_lock lock(m_mutex);
+            for( ;; )
+            {
+                while( !m_pending && !m_stop )
+                    m_cond.wait(lock);
+
+                if( !m_pending )
+                    break;
+
+                // Write without holding the lock, so loggers can keep filling
+                // the other buffer.
+                char* const data = m_pending;
+                const size_t skip = m_pendingSkip;
+                const unsigned long long offset = m_pendingOffset;
+                lock.unlock();
+                const bool ok = writeBlock(data + skip, m_capacity - skip, offset + skip);
+                lock.lock();
+
+                if( !ok )
+                    m_failed = true;
+                m_pending = NULL;
+                m_cond.notify_all();
+            }
+        }
+    };
+
+    // Unbuffered streambuf feeding a direct_file_writer.  sync() is a no-op;
+    // durability points are explicit calls to direct_file_stream::flush_file().
+    // Once a write to the file has failed, output is reported as failed so the
+    // stream goes bad.
+    class direct_file_streambuf : public std::streambuf
+    {
+    private:
+        direct_file_writer& m_writer;
+
+    public:
+        direct_file_streambuf(direct_file_writer& writer)
+            : m_writer(writer)
+        { }
+
+    protected:
+        virtual std::streamsize xsputn(const char* s, std::streamsize n)
+        {
+            return m_writer.write(s, static_cast<size_t>(n)) ? n : 0;
+        }
+
+        virtual int_type overflow(int_type c)
+        {
+            if( !traits_type::eq_int_type(c, traits_type::eof()) )
+            {
+                char ch = traits_type::to_char_type(c);
+                if( !m_writer.write(&ch, 1) )
+                    return traits_type::eof();
+            }
+            return traits_type::not_eof(c);
+        }
+    };
+
+    class direct_file_stream : public std::ostream
+    {
+    private:
+        direct_file_writer      m_writer;
+        direct_file_streambuf   m_buf;
+
+    public:
+        direct_file_stream()
+            : std::ostream(NULL), m_buf(m_writer)
+        {
+            rdbuf(&m_buf);
+        }
+
+        bool open(const std::string& path, bool append, size_t bufferSize = 1024 * 1024)
+        {
+            bool ok = m_writer.open(path, append, bufferSize);
+            if( !ok )
+                setstate(std::ios_base::badbit);
+            return ok;
+        }
+
+        bool is_direct() const  { return m_writer.is_direct(); }
+
+        void flush_file()
+        {
+            m_writer.flush();
+            if( m_writer.failed() )
+                setstate(std::ios_base::badbit);
+        }
+
+        void close()            { m_writer.close(); }
+    };
+}
+
+#endif